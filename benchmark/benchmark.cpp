@@ -0,0 +1,364 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "graphics.hpp"
+#include "gradient.hpp"
+#include "print.hpp"
+#include "RobotoMono16.font"
+#include "RobotoMono32.font"
+#include "RobotoMono72.font"
+
+// Minimum time spent on each case, raise it for steadier numbers
+#ifndef BENCH_MIN_TIME_US
+#define BENCH_MIN_TIME_US   100000
+#endif
+#define BENCH_MIN_CALLS     3
+
+// Largest display and bitmap that are benchmarked
+#define BENCH_MAX_WIDTH     320
+#define BENCH_MAX_HEIGHT    320
+#define BENCH_BITMAP_SIZE   128
+
+// Everything a case draws with
+typedef struct
+{
+    graphics* gfx;
+    gradient* grad;
+    printer* text;
+    display_config_t* config;
+} bench_context_t;
+
+// Draws one call of a case, returns the number of pixels it covered
+typedef uint32_t (*bench_function_t)(bench_context_t* context, uint32_t size);
+
+typedef struct
+{
+    const char* name;
+    bench_function_t function;
+    bool scalable;  // false if the case always covers the whole display
+} bench_case_t;
+
+// Shape sizes in pixels, the largest still fits on every display
+static const uint32_t sizes[] = { 16, 64, 200 };
+
+static const struct
+{
+    const char* name;
+    uint32_t width;
+    uint32_t height;
+} displays[] = {
+    { "GC9A01", 240, 240 },
+    { "ST7789", 240, 320 },
+    { "ST7789", 320, 240 },
+};
+
+static uint16_t frameBuffer[BENCH_MAX_WIDTH * BENCH_MAX_HEIGHT];
+static uint16_t bitmap[BENCH_BITMAP_SIZE * BENCH_BITMAP_SIZE];
+static uint8_t mask[BENCH_BITMAP_SIZE * BENCH_BITMAP_SIZE];
+
+/**
+ * @brief Get the point that centers a square of the given size on the display
+ * @param context Context to get the display size from
+ * @param size Size of the square
+ * @return point Upper left corner of the square
+*/
+static point origin(bench_context_t* context, uint32_t size)
+{
+    return point((context->config->width - size) / 2, (context->config->height - size) / 2);
+}
+
+/**
+ * @brief Approximate the area of a circle
+ * @param radius Radius of the circle
+ * @return uint32_t Number of pixels
+*/
+static uint32_t circleArea(uint32_t radius)
+{
+    return (355 * radius * radius) / 113;
+}
+
+static uint32_t benchFill(bench_context_t* context, uint32_t size)
+{
+    context->gfx->fill(colors::blue);
+    return context->config->width * context->config->height;
+}
+
+static uint32_t benchDrawLine(bench_context_t* context, uint32_t size)
+{
+    point start = origin(context, size);
+    context->gfx->drawLine(start, start + point(size - 1, size / 2), colors::white);
+    return size;
+}
+
+static uint32_t benchDrawLineAntiAliased(bench_context_t* context, uint32_t size)
+{
+    point start = origin(context, size);
+    context->gfx->drawLineAntiAliased(start, start + point(size - 1, size / 2), colors::white);
+    return size;
+}
+
+static uint32_t benchDrawLineThickAntiAliased(bench_context_t* context, uint32_t size)
+{
+    point start = origin(context, size);
+    context->gfx->drawLineThickAntiAliased(start, start + point(size - 1, size / 2), 5, colors::white, CapRound);
+    return size * 5;
+}
+
+static uint32_t benchDrawPolyline(bench_context_t* context, uint32_t size)
+{
+    // a zigzag across the square
+    point start = origin(context, size);
+    point points[5] = {
+        start + point(0, size - 1),
+        start + point(size / 4, 0),
+        start + point(size / 2, size - 1),
+        start + point(size * 3 / 4, 0),
+        start + point(size - 1, size - 1),
+    };
+    context->gfx->drawPolyline(points, 5, 5, colors::white, CapButt, JoinMiter);
+    return size * 4 * 5;
+}
+
+static uint32_t benchDrawFilledCircle(bench_context_t* context, uint32_t size)
+{
+    point center = origin(context, size) + point(size / 2, size / 2);
+    context->gfx->drawFilledCircle(center, size / 2, colors::red);
+    return circleArea(size / 2);
+}
+
+static uint32_t benchDrawFilledCircleAntiAliased(bench_context_t* context, uint32_t size)
+{
+    point center = origin(context, size) + point(size / 2, size / 2);
+    context->gfx->drawFilledCircleAntiAliased(center, size / 2, colors::red);
+    return circleArea(size / 2);
+}
+
+static uint32_t benchDrawFilledEllipse(bench_context_t* context, uint32_t size)
+{
+    point center = origin(context, size) + point(size / 2, size / 2);
+    context->gfx->drawFilledEllipse(center, size / 2, size / 4, colors::red);
+    return circleArea(size / 2) / 2;
+}
+
+static uint32_t benchDrawRectangle(bench_context_t* context, uint32_t size)
+{
+    point start = origin(context, size);
+    context->gfx->drawRectangle(start, start + point(size - 1, size - 1), colors::white);
+    return size * 4;
+}
+
+static uint32_t benchDrawFilledRoundedRectangle(bench_context_t* context, uint32_t size)
+{
+    point start = origin(context, size);
+    context->gfx->drawFilledRoundedRectangle(start, start + point(size, size), size / 8, colors::red);
+    return size * size;
+}
+
+static uint32_t benchDrawFilledTriangle(bench_context_t* context, uint32_t size)
+{
+    point start = origin(context, size);
+    context->gfx->drawFilledTriangle(start, start + point(size - 1, size / 3), start + point(size / 4, size - 1), colors::green);
+    return size * size / 2;
+}
+
+static uint32_t benchDrawFilledPolygon(bench_context_t* context, uint32_t size)
+{
+    // a hexagon with the corners on the edges of the square
+    point start = origin(context, size);
+    point points[6] = {
+        start + point(size / 4, 0),
+        start + point(size * 3 / 4, 0),
+        start + point(size - 1, size / 2),
+        start + point(size * 3 / 4, size - 1),
+        start + point(size / 4, size - 1),
+        start + point(0, size / 2),
+    };
+    context->gfx->drawFilledPolygon(points, 6, colors::yellow);
+    return size * size * 3 / 4;
+}
+
+static uint32_t benchDrawFilledDualArc(bench_context_t* context, uint32_t size)
+{
+    point center = origin(context, size) + point(size / 2, size / 2);
+    context->gfx->drawFilledDualArc(center, size / 4, size / 2, 0, 270, colors::cyan);
+    return (circleArea(size / 2) - circleArea(size / 4)) * 3 / 4;
+}
+
+static uint32_t benchDrawFilledDualArcAntiAliased(bench_context_t* context, uint32_t size)
+{
+    point center = origin(context, size) + point(size / 2, size / 2);
+    context->gfx->drawFilledDualArcAntiAliased(center, size / 4, size / 2, 0, 270, colors::cyan);
+    return (circleArea(size / 2) - circleArea(size / 4)) * 3 / 4;
+}
+
+static uint32_t benchDrawBitmap(bench_context_t* context, uint32_t size)
+{
+    if (size > BENCH_BITMAP_SIZE)
+        size = BENCH_BITMAP_SIZE;
+    context->gfx->drawBitmap(bitmap, size, size, origin(context, size));
+    return size * size;
+}
+
+static uint32_t benchDrawTranslucentRectangle(bench_context_t* context, uint32_t size)
+{
+    point start = origin(context, size);
+    context->gfx->drawTranslucentRectangle(start, start + point(size, size), colors::red, 128);
+    return size * size;
+}
+
+static uint32_t benchDrawBitmapAlpha(bench_context_t* context, uint32_t size)
+{
+    if (size > BENCH_BITMAP_SIZE)
+        size = BENCH_BITMAP_SIZE;
+    context->gfx->drawBitmap(bitmap, size, size, origin(context, size), 128);
+    return size * size;
+}
+
+static uint32_t benchDrawBitmapMasked(bench_context_t* context, uint32_t size)
+{
+    if (size > BENCH_BITMAP_SIZE)
+        size = BENCH_BITMAP_SIZE;
+    context->gfx->drawBitmapMasked(bitmap, mask, size, size, origin(context, size));
+    return size * size;
+}
+
+static uint32_t benchScroll(bench_context_t* context, uint32_t size)
+{
+    point start = origin(context, size);
+    context->gfx->scroll(start, start + point(size, size), -1, 0);
+    return size * size;
+}
+
+static uint32_t benchAddBlur(bench_context_t* context, uint32_t size)
+{
+    context->gfx->addBlur();
+    return context->config->width * context->config->height;
+}
+
+static uint32_t benchAddFloydSteinbergDithering(bench_context_t* context, uint32_t size)
+{
+    context->gfx->addFloydSteinbergDithering();
+    return context->config->width * context->config->height;
+}
+
+static uint32_t benchFillGradient(bench_context_t* context, uint32_t size)
+{
+    // the points only give the direction, the gradient covers the whole display
+    context->grad->fillGradient(colors::red, colors::blue, point(0, 0), point(context->config->width - 1, context->config->height / 2));
+    return context->config->width * context->config->height;
+}
+
+static uint32_t benchPrint(bench_context_t* context, uint32_t size)
+{
+    // pick the font that fills about the same height as the other shapes
+    if (size <= 16)
+        context->text->setFont(&RobotoMono16);
+    else if (size <= 64)
+        context->text->setFont(&RobotoMono32);
+    else
+        context->text->setFont(&RobotoMono72);
+
+    context->text->setString("PicoGFX");
+    context->text->setCursor(point(0, (context->config->height - context->text->getStringHeight()) / 2));
+    context->text->print();
+    return context->text->getStringWidth() * context->text->getStringHeight();
+}
+
+static const bench_case_t cases[] = {
+    { "fill", benchFill, false },
+    { "drawLine", benchDrawLine, true },
+    { "drawLineAntiAliased", benchDrawLineAntiAliased, true },
+    { "drawLineThickAntiAliased", benchDrawLineThickAntiAliased, true },
+    { "drawPolyline", benchDrawPolyline, true },
+    { "drawFilledCircle", benchDrawFilledCircle, true },
+    { "drawFilledCircleAntiAliased", benchDrawFilledCircleAntiAliased, true },
+    { "drawFilledEllipse", benchDrawFilledEllipse, true },
+    { "drawRectangle", benchDrawRectangle, true },
+    { "drawFilledRoundedRectangle", benchDrawFilledRoundedRectangle, true },
+    { "drawFilledTriangle", benchDrawFilledTriangle, true },
+    { "drawFilledPolygon", benchDrawFilledPolygon, true },
+    { "drawFilledDualArc", benchDrawFilledDualArc, true },
+    { "drawFilledDualArcAntiAliased", benchDrawFilledDualArcAntiAliased, true },
+    { "drawBitmap", benchDrawBitmap, true },
+    { "drawTranslucentRectangle", benchDrawTranslucentRectangle, true },
+    { "drawBitmap alpha", benchDrawBitmapAlpha, true },
+    { "drawBitmapMasked", benchDrawBitmapMasked, true },
+    { "scroll", benchScroll, true },
+    { "addBlur", benchAddBlur, false },
+    { "addFloydSteinbergDithering", benchAddFloydSteinbergDithering, false },
+    { "fillGradient", benchFillGradient, false },
+    { "print", benchPrint, true },
+};
+
+/**
+ * @brief Run a case until it has taken long enough to be measured and print the result
+ * @param context Context to draw with
+ * @param displayName Name of the display being benchmarked
+ * @param benchCase Case to run
+ * @param size Size of the shape
+*/
+static void run(bench_context_t* context, const char* displayName, const bench_case_t* benchCase, uint32_t size)
+{
+    // warm up caches and anything that is set up lazily
+    context->gfx->fill(colors::black);
+    benchCase->function(context, size);
+
+    uint32_t calls = 0;
+    uint64_t pixels = 0;
+    uint64_t start = time_us_64();
+    uint64_t elapsed = 0;
+    do
+    {
+        pixels += benchCase->function(context, size);
+        calls++;
+        elapsed = time_us_64() - start;
+    } while (elapsed < BENCH_MIN_TIME_US || calls < BENCH_MIN_CALLS);
+
+    double nanoseconds = (double)elapsed * 1000.0;
+    printf("%-7s %3ux%-3u  %-29s %4u  %8u  %10.2f  %8.3f  %8.2f\n",
+        displayName, context->config->width, context->config->height, benchCase->name,
+        benchCase->scalable ? size : 0, calls, nanoseconds / calls / 1000.0,
+        nanoseconds / pixels, pixels / ((double)elapsed / 1000000.0) / 1000000.0);
+}
+
+int main(void)
+{
+    stdio_init_all();
+
+    // a pattern that does not compress into a single color for the filters and bitmap
+    for (uint32_t i = 0; i < BENCH_BITMAP_SIZE * BENCH_BITMAP_SIZE; i++)
+    {
+        bitmap[i] = (uint16_t)(i * 2654435761u >> 16);
+        mask[i] = (uint8_t)(i * 40503u >> 8);
+    }
+
+    printf("%-7s %-7s  %-29s %4s  %8s  %10s  %8s  %8s\n",
+        "display", "size", "case", "px", "calls", "us/call", "ns/px", "Mpx/s");
+
+    for (const auto& display : displays)
+    {
+        display_config_t config = {
+            .height = display.height,
+            .width = display.width,
+        };
+
+        graphics gfx(frameBuffer, &config);
+        gradient grad(frameBuffer, &config);
+        printer text(frameBuffer, &config);
+        text.setColor(colors::white);
+        bench_context_t context = { &gfx, &grad, &text, &config };
+
+        for (const bench_case_t& benchCase : cases)
+        {
+            if (!benchCase.scalable)
+            {
+                run(&context, display.name, &benchCase, 0);
+                continue;
+            }
+
+            for (uint32_t size : sizes)
+                run(&context, display.name, &benchCase, size);
+        }
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+# Host stand-in for pioasm
+#
+# The programs never run on the host, so only the symbols the C side refers to
+# are generated: the program struct, the wrap defines, the default config helper
+# and the verbatim c-sdk blocks. Invoked as
+#   cmake -DINPUT=<file.pio> -DOUTPUT=<file.pio.h> -P pio_header.cmake
+
+file(STRINGS ${INPUT} lines)
+
+set(header "// Generated from ${INPUT} for host builds, do not edit\n\n#pragma once\n\n#include \"hardware/pio.h\"\n\n")
+set(programs "")
+set(in_block FALSE)
+set(blocks "")
+
+foreach(line IN LISTS lines)
+    if(in_block)
+        if(line MATCHES "^%}")
+            set(in_block FALSE)
+        else()
+            string(APPEND blocks "${line}\n")
+        endif()
+        continue()
+    endif()
+
+    string(STRIP "${line}" stripped)
+    # drop comments
+    string(REGEX REPLACE ";.*$" "" stripped "${stripped}")
+    string(STRIP "${stripped}" stripped)
+
+    if(stripped MATCHES "^% *c-sdk *{")
+        set(in_block TRUE)
+    elseif(stripped MATCHES "^\\.program +([A-Za-z0-9_]+)")
+        set(program ${CMAKE_MATCH_1})
+        list(APPEND programs ${program})
+        set(${program}_count 0)
+        set(${program}_wrap_target 0)
+        set(${program}_wrap -1)
+        set(${program}_sideset_bits 0)
+        set(${program}_sideset_opt false)
+    elseif(stripped MATCHES "^\\.side_set +([0-9]+)( +opt)?")
+        set(${program}_sideset_bits ${CMAKE_MATCH_1})
+        if(CMAKE_MATCH_2)
+            math(EXPR ${program}_sideset_bits "${CMAKE_MATCH_1} + 1")
+            set(${program}_sideset_opt true)
+        endif()
+    elseif(stripped STREQUAL ".wrap_target")
+        set(${program}_wrap_target ${${program}_count})
+    elseif(stripped STREQUAL ".wrap")
+        math(EXPR ${program}_wrap "${${program}_count} - 1")
+    elseif(stripped STREQUAL "" OR stripped MATCHES "^[.%]" OR stripped MATCHES "^[A-Za-z0-9_]+:$")
+        # directive, label or blank line
+    elseif(program)
+        math(EXPR ${program}_count "${${program}_count} + 1")
+    endif()
+endforeach()
+
+foreach(program IN LISTS programs)
+    set(count ${${program}_count})
+    set(wrap ${${program}_wrap})
+    if(wrap LESS 0)
+        math(EXPR wrap "${count} - 1")
+    endif()
+
+    set(instructions "")
+    foreach(i RANGE 1 ${count})
+        string(APPEND instructions "    0x0000,\n")
+    endforeach()
+
+    string(APPEND header
+        "#define ${program}_wrap_target ${${program}_wrap_target}\n"
+        "#define ${program}_wrap ${wrap}\n\n"
+        "static const uint16_t ${program}_program_instructions[] = {\n${instructions}};\n\n"
+        "static const struct pio_program ${program}_program = {\n"
+        "    .instructions = ${program}_program_instructions,\n"
+        "    .length = ${count},\n"
+        "    .origin = -1,\n"
+        "};\n\n"
+        "static inline pio_sm_config ${program}_program_get_default_config(uint offset)\n{\n"
+        "    pio_sm_config c = pio_get_default_sm_config();\n"
+        "    sm_config_set_wrap(&c, offset + ${program}_wrap_target, offset + ${program}_wrap);\n"
+        "    sm_config_set_sideset(&c, ${${program}_sideset_bits}, ${${program}_sideset_opt}, false);\n"
+        "    return c;\n}\n\n")
+endforeach()
+
+string(APPEND header "${blocks}")
+file(WRITE ${OUTPUT} "${header}")
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct i2c_inst i2c_inst_t;
+
+#ifdef __cplusplus
+}
+#endif
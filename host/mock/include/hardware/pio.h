@@ -0,0 +1,122 @@
+#pragma once
+
+#include "pico/types.h"
+#include "hardware/gpio.h"
+#include "hardware/pio_instructions.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define NUM_PIO_STATE_MACHINES 4
+#define PIO_FDEBUG_TXSTALL_LSB 24
+#define PIO_FDEBUG_TXSTALL_BITS 0x0f000000u
+
+#define PIO_SM0_SHIFTCTRL_AUTOPULL_BITS 0x00020000u
+#define PIO_SM0_SHIFTCTRL_OUT_SHIFTDIR_BITS 0x00080000u
+#define PIO_SM0_SHIFTCTRL_PULL_THRESH_LSB 25
+#define PIO_SM0_SHIFTCTRL_PULL_THRESH_BITS 0x3e000000u
+
+typedef struct
+{
+    io_rw_32 clkdiv;
+    io_rw_32 execctrl;
+    io_rw_32 shiftctrl;
+    io_ro_32 addr;
+    io_rw_32 instr;
+    io_rw_32 pinctrl;
+} pio_sm_hw_t;
+
+typedef struct
+{
+    io_rw_32 ctrl;
+    io_ro_32 fstat;
+    io_rw_32 fdebug;
+    io_ro_32 flevel;
+    io_wo_32 txf[NUM_PIO_STATE_MACHINES];
+    io_ro_32 rxf[NUM_PIO_STATE_MACHINES];
+    io_rw_32 irq;
+    io_wo_32 irq_force;
+    io_rw_32 input_sync_bypass;
+    io_ro_32 dbg_padout;
+    io_ro_32 dbg_padoe;
+    io_ro_32 dbg_cfginfo;
+    io_wo_32 instr_mem[32];
+    pio_sm_hw_t sm[NUM_PIO_STATE_MACHINES];
+} pio_hw_t;
+
+typedef pio_hw_t* PIO;
+
+extern pio_hw_t mock_pio_hw[2];
+
+#define pio0 (&mock_pio_hw[0])
+#define pio1 (&mock_pio_hw[1])
+
+typedef struct pio_program
+{
+    const uint16_t* instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+typedef struct
+{
+    uint32_t clkdiv;
+    uint32_t execctrl;
+    uint32_t shiftctrl;
+    uint32_t pinctrl;
+    // kept unpacked so the mock can inspect the configuration
+    uint out_base;
+    uint out_count;
+    uint sideset_base;
+    uint sideset_bit_count;
+    bool sideset_optional;
+    bool out_shift_right;
+    bool autopull;
+    uint pull_threshold;
+    float clk_div;
+} pio_sm_config;
+
+enum pio_fifo_join
+{
+    PIO_FIFO_JOIN_NONE = 0,
+    PIO_FIFO_JOIN_TX = 1,
+    PIO_FIFO_JOIN_RX = 2,
+};
+
+static inline uint pio_get_index(PIO pio) { return pio == pio1 ? 1u : 0u; }
+static inline uint pio_get_dreq(PIO pio, uint sm, bool is_tx) { return pio_get_index(pio) * 8u + sm + (is_tx ? 0u : 4u); }
+
+pio_sm_config pio_get_default_sm_config(void);
+void sm_config_set_out_pins(pio_sm_config* c, uint out_base, uint out_count);
+void sm_config_set_set_pins(pio_sm_config* c, uint set_base, uint set_count);
+void sm_config_set_sideset_pins(pio_sm_config* c, uint sideset_base);
+void sm_config_set_sideset(pio_sm_config* c, uint bit_count, bool optional, bool pindirs);
+void sm_config_set_wrap(pio_sm_config* c, uint wrap_target, uint wrap);
+void sm_config_set_clkdiv(pio_sm_config* c, float div);
+void sm_config_set_out_shift(pio_sm_config* c, bool shift_right, bool autopull, uint pull_threshold);
+void sm_config_set_fifo_join(pio_sm_config* c, enum pio_fifo_join join);
+
+uint pio_add_program(PIO pio, const pio_program_t* program);
+void pio_remove_program(PIO pio, const pio_program_t* program, uint loaded_offset);
+int pio_claim_unused_sm(PIO pio, bool required);
+void pio_sm_unclaim(PIO pio, uint sm);
+void pio_gpio_init(PIO pio, uint pin);
+int pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config* config);
+void pio_sm_set_config(PIO pio, uint sm, const pio_sm_config* config);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+void pio_sm_restart(PIO pio, uint sm);
+void pio_sm_clear_fifos(PIO pio, uint sm);
+void pio_sm_exec(PIO pio, uint sm, uint instr);
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out);
+void pio_sm_set_pins_with_mask(PIO pio, uint sm, uint32_t pin_values, uint32_t pin_mask);
+void pio_sm_set_pindirs_with_mask(PIO pio, uint sm, uint32_t pin_dirs, uint32_t pin_mask);
+void pio_sm_put(PIO pio, uint sm, uint32_t data);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm);
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm);
+
+#ifdef __cplusplus
+}
+#endif
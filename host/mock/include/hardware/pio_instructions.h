@@ -0,0 +1,40 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+enum pio_src_dest
+{
+    pio_pins = 0u,
+    pio_x = 1u,
+    pio_y = 2u,
+    pio_null = 3u,
+    pio_pindirs = 4u,
+    pio_exec_mov = 4u,
+    pio_status = 5u,
+    pio_pc = 5u,
+    pio_isr = 6u,
+    pio_osr = 7u,
+    pio_exec_out = 7u,
+};
+
+static inline uint pio_encode_sideset(uint sideset_bit_count, uint value)
+{
+    return value << (13u - sideset_bit_count);
+}
+
+static inline uint pio_encode_delay(uint cycles) { return cycles << 8u; }
+static inline uint pio_encode_jmp(uint addr) { return 0x0000u | (addr & 0x1fu); }
+static inline uint pio_encode_out(enum pio_src_dest dest, uint count) { return 0x6000u | (((uint)dest & 7u) << 5u) | (count & 0x1fu); }
+static inline uint pio_encode_pull(bool if_empty, bool block) { return 0x8080u | (if_empty ? 0x40u : 0u) | (block ? 0x20u : 0u); }
+static inline uint pio_encode_mov(enum pio_src_dest dest, enum pio_src_dest src) { return 0xa000u | (((uint)dest & 7u) << 5u) | ((uint)src & 7u); }
+static inline uint pio_encode_set(enum pio_src_dest dest, uint value) { return 0xe000u | (((uint)dest & 7u) << 5u) | (value & 0x1fu); }
+static inline uint pio_encode_nop(void) { return pio_encode_mov(pio_y, pio_y); }
+
+#ifdef __cplusplus
+}
+#endif
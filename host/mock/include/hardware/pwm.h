@@ -0,0 +1,18 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+static inline uint pwm_gpio_to_slice_num(uint gpio) { return (gpio >> 1u) & 7u; }
+static inline uint pwm_gpio_to_channel(uint gpio) { return gpio & 1u; }
+static inline void pwm_set_enabled(uint slice_num, bool enabled) { (void)slice_num; (void)enabled; }
+static inline void pwm_set_wrap(uint slice_num, uint16_t wrap) { (void)slice_num; (void)wrap; }
+static inline void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level) { (void)slice_num; (void)chan; (void)level; }
+
+#ifdef __cplusplus
+}
+#endif
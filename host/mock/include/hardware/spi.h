@@ -0,0 +1,64 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct
+{
+    io_rw_32 cr0;
+    io_rw_32 cr1;
+    io_rw_32 dr;
+    io_ro_32 sr;
+    io_rw_32 cpsr;
+    io_rw_32 imsc;
+    io_ro_32 ris;
+    io_ro_32 mis;
+    io_rw_32 icr;
+    io_rw_32 dmacr;
+} spi_hw_t;
+
+typedef struct spi_inst spi_inst_t;
+
+typedef enum
+{
+    SPI_CPHA_0 = 0,
+    SPI_CPHA_1 = 1
+} spi_cpha_t;
+
+typedef enum
+{
+    SPI_CPOL_0 = 0,
+    SPI_CPOL_1 = 1
+} spi_cpol_t;
+
+typedef enum
+{
+    SPI_LSB_FIRST = 0,
+    SPI_MSB_FIRST = 1
+} spi_order_t;
+
+#define SPI_SSPICR_RORIC_BITS 0x00000001u
+
+extern spi_hw_t mock_spi_hw[2];
+
+#define spi0 ((spi_inst_t*)&mock_spi_hw[0])
+#define spi1 ((spi_inst_t*)&mock_spi_hw[1])
+
+static inline spi_hw_t* spi_get_hw(spi_inst_t* spi) { return (spi_hw_t*)spi; }
+static inline uint spi_get_index(const spi_inst_t* spi) { return spi == spi1 ? 1u : 0u; }
+static inline uint spi_get_dreq(spi_inst_t* spi, bool is_tx) { return 16u + spi_get_index(spi) * 2u + (is_tx ? 0u : 1u); }
+
+uint spi_init(spi_inst_t* spi, uint baudrate);
+void spi_set_format(spi_inst_t* spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order);
+int spi_write_blocking(spi_inst_t* spi, const uint8_t* src, size_t len);
+int spi_write16_blocking(spi_inst_t* spi, const uint16_t* src, size_t len);
+bool spi_is_busy(const spi_inst_t* spi);
+bool spi_is_readable(const spi_inst_t* spi);
+
+#ifdef __cplusplus
+}
+#endif
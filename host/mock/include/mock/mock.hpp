@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "hardware/spi.h"
+#include "hardware/pio.h"
+
+// A single write cycle as seen on the display bus
+struct mock_bus_event
+{
+    bool dc;        // false for a command, true for data
+    uint32_t value;
+    uint8_t bits;
+};
+
+// A DMA transfer as it was retired by the mock engine
+struct mock_dma_transfer
+{
+    uint32_t channel;
+    uint32_t count;
+    uint32_t size;  // bytes per element
+    bool toPeripheral;
+};
+
+/**
+ * @brief Decodes a MIPI DCS style byte stream into an in-memory panel image
+ * @note Understands CASET, RASET and RAMWR, everything else is only counted
+ */
+class mock_panel
+{
+public:
+    mock_panel(uint32_t width, uint32_t height, uint8_t CASET = 0x2a, uint8_t RASET = 0x2b, uint8_t RAMWR = 0x2c);
+
+    void write(bool dc, uint32_t value, uint32_t bits);
+    void clear(uint16_t color = 0);
+
+    uint32_t getWidth(void) { return this->width; }
+    uint32_t getHeight(void) { return this->height; }
+    uint16_t getPixel(uint32_t x, uint32_t y) { return this->memory[x + y * this->width]; }
+    const uint16_t* getMemory(void) { return this->memory.data(); }
+    uint32_t getCommandCount(uint8_t command) { return this->commandCount[command]; }
+    uint32_t getPixelsWritten(void) { return this->pixelsWritten; }
+    void resetCounters(void);
+
+private:
+    uint32_t width;
+    uint32_t height;
+    uint8_t CASET;
+    uint8_t RASET;
+    uint8_t RAMWR;
+    std::vector<uint16_t> memory;
+    uint32_t commandCount[256] = {0};
+    uint32_t pixelsWritten = 0;
+
+    uint8_t command = 0;
+    uint32_t parameter = 0;
+    uint8_t parameters[4] = {0};
+    int32_t pendingByte = -1;
+    uint32_t x0 = 0, x1 = 0, y0 = 0, y1 = 0;
+    uint32_t x = 0, y = 0;
+
+    void pixel(uint16_t value);
+};
+
+namespace mock
+{
+    // Reset all peripherals, listeners and recorders
+    void reset(void);
+
+    // Bus decoding, the data/command line is sampled from the given GPIO
+    void attachSPI(spi_inst_t* spi, uint32_t dcPin);
+    void attach8080(const uint32_t* dataPins, size_t count, uint32_t wrPin, uint32_t dcPin);
+    void attachPIO(PIO pio, uint32_t sm, uint32_t dcPin, uint32_t bits);
+    void attachPanel(mock_panel* panel);
+
+    // Keep every bus cycle around for inspection, off by default
+    void recordBus(bool enabled);
+    const std::vector<mock_bus_event>& getBusEvents(void);
+    uint64_t getBusBytes(void);
+
+    // DMA bookkeeping
+    void setDeferredDMA(bool deferred);
+    uint32_t runPendingDMA(void);
+    const std::vector<mock_dma_transfer>& getDMATransfers(void);
+    uint32_t getClaimedDMAChannels(void);
+
+    // Virtual time spent in sleep_ms/sleep_us
+    uint64_t getSleptTime(void);
+
+    void clearRecorders(void);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+static inline int32_t div_s32s32(int32_t a, int32_t b)
+{
+    return b ? a / b : (a < 0 ? 1 : -1);
+}
+
+static inline int32_t divmod_s32s32_rem(int32_t a, int32_t b, int32_t* rem)
+{
+    if (!b)
+    {
+        *rem = a;
+        return a < 0 ? 1 : -1;
+    }
+    *rem = a % b;
+    return a / b;
+}
+
+static inline uint32_t div_u32u32(uint32_t a, uint32_t b)
+{
+    return b ? a / b : 0xffffffffu;
+}
+
+static inline uint32_t divmod_u32u32_rem(uint32_t a, uint32_t b, uint32_t* rem)
+{
+    if (!b)
+    {
+        *rem = a;
+        return 0xffffffffu;
+    }
+    *rem = a % b;
+    return a / b;
+}
+
+#ifdef __cplusplus
+}
+#endif
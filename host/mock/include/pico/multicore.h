@@ -0,0 +1,23 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Core 1 is a std::thread, the FIFOs are 8 deep in both directions like on the RP2040
+void multicore_launch_core1(void (*entry)(void));
+// Waits for the core 1 thread to return, a thread cannot be stopped from the outside
+void multicore_reset_core1(void);
+
+bool multicore_fifo_rvalid(void);
+bool multicore_fifo_wready(void);
+void multicore_fifo_push_blocking(uint32_t data);
+uint32_t multicore_fifo_pop_blocking(void);
+void multicore_fifo_drain(void);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
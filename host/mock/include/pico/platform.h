@@ -0,0 +1,17 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Spin loops call this, the mock uses it to retire deferred DMA transfers
+void tight_loop_contents(void);
+
+uint get_core_num(void);
+
+#ifdef __cplusplus
+}
+#endif
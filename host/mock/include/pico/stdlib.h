@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdio.h>
+#include "pico/types.h"
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+#ifndef PICO_DEFAULT_LED_PIN
+#define PICO_DEFAULT_LED_PIN 25
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+bool stdio_init_all(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Sleeps advance a virtual clock instead of blocking the host
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+
+#ifdef __cplusplus
+}
+#endif
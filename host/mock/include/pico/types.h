@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+typedef volatile uint32_t io_rw_32;
+typedef volatile uint32_t io_ro_32;   // writable so the mock can play the hardware side
+typedef volatile uint32_t io_wo_32;
+typedef volatile uint16_t io_rw_16;
+typedef volatile uint8_t io_rw_8;
+
+#ifndef __not_in_flash_func
+#define __not_in_flash_func(func_name) func_name
+#endif
+#ifndef __time_critical_func
+#define __time_critical_func(func_name) func_name
+#endif
+#ifndef __scratch_x
+#define __scratch_x(group)
+#endif
+#ifndef __scratch_y
+#define __scratch_y(group)
+#endif
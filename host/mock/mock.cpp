@@ -0,0 +1,1016 @@
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/spi.h"
+#include "mock/mock.hpp"
+
+spi_hw_t mock_spi_hw[2];
+pio_hw_t mock_pio_hw[2];
+
+// core 1 runs on its own thread, the FIFOs are the only shared state between the cores
+namespace
+{
+    const size_t fifoDepth = 8;
+
+    thread_local uint mockCore = 0;
+    std::thread core1;
+    std::mutex fifoLock;
+    std::condition_variable fifoChanged;
+    std::deque<uint32_t> fifo[2];   // indexed by the receiving core
+}
+
+namespace
+{
+    struct dma_channel_state
+    {
+        bool claimed = false;
+        uint32_t ctrl = 0;
+        const volatile void* read = nullptr;
+        volatile void* write = nullptr;
+        uint32_t count = 0;
+        bool busy = false;
+        bool irq0 = false;
+        bool irq0Status = false;
+    };
+
+    struct pio_sink
+    {
+        bool attached = false;
+        uint32_t dcPin = 0;
+        uint32_t bits = 16;
+
+        // pins from the state machine config
+        uint32_t outBase = 0;
+        uint32_t outCount = 0;
+        uint32_t sidesetBase = 0;
+    };
+
+    struct state
+    {
+        // gpio
+        uint32_t gpioOut = 0;
+        uint32_t gpioDir = 0;
+
+        // listeners
+        spi_inst_t* spi = nullptr;
+        uint32_t spiDcPin = 0;
+        uint32_t spiBits = 8;
+        std::vector<uint32_t> parallelPins;
+        int32_t parallelWr = -1;
+        uint32_t parallelDc = 0;
+        pio_sink pio[2][NUM_PIO_STATE_MACHINES];
+        mock_panel* panel = nullptr;
+
+        // recorders
+        bool record = false;
+        std::vector<mock_bus_event> events;
+        uint64_t busBytes = 0;
+        std::vector<mock_dma_transfer> transfers;
+
+        // dma
+        dma_channel_state dma[NUM_DMA_CHANNELS];
+        bool deferred = false;
+        std::vector<uint32_t> pending;
+
+        // irq
+        std::map<uint, std::vector<irq_handler_t>> handlers;
+        std::map<uint, bool> irqEnabled;
+
+        // pio
+        uint32_t smClaimed[2] = {0, 0};
+        uint32_t programOffset[2] = {0, 0};
+
+        // time
+        uint64_t slept = 0;
+    };
+
+    state s;
+    const auto start = std::chrono::steady_clock::now();
+
+    void busWrite(bool dc, uint32_t value, uint32_t bits)
+    {
+        if (s.record)
+            s.events.push_back({dc, value, (uint8_t)bits});
+        s.busBytes += bits / 8;
+        if (s.panel != nullptr)
+            s.panel->write(dc, value, bits);
+    }
+
+    bool gpioState(uint32_t pin)
+    {
+        return (s.gpioOut >> pin) & 1u;
+    }
+
+    void sampleParallel(void)
+    {
+        uint32_t value = 0;
+        for (size_t i = 0; i < s.parallelPins.size(); i++)
+            value |= (uint32_t)gpioState(s.parallelPins[i]) << i;
+        busWrite(gpioState(s.parallelDc), value, (uint32_t)s.parallelPins.size());
+    }
+
+    void setGpio(uint32_t mask, uint32_t value)
+    {
+        uint32_t old = s.gpioOut;
+        s.gpioOut = (old & ~mask) | (value & mask);
+
+        // a rising write strobe latches the data bus
+        if (s.parallelWr >= 0)
+        {
+            uint32_t wr = 1u << s.parallelWr;
+            if ((mask & wr) && !(old & wr) && (s.gpioOut & wr))
+                sampleParallel();
+        }
+    }
+
+    bool peripheralWrite(volatile void* address, uint32_t value, uint32_t size)
+    {
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            if (address == &mock_spi_hw[i].dr)
+            {
+                if ((spi_inst_t*)&mock_spi_hw[i] == s.spi)
+                    busWrite(gpioState(s.spiDcPin), value & ((1u << s.spiBits) - 1), s.spiBits);
+                return true;
+            }
+
+            for (uint32_t sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++)
+            {
+                if (address != &mock_pio_hw[i].txf[sm])
+                    continue;
+
+                pio_sink& sink = s.pio[i][sm];
+                if (!sink.attached && sink.outCount > 1 && s.parallelWr == (int32_t)sink.sidesetBase)
+                {
+                    // a parallel bus program, drive the out pins and strobe WR
+                    uint32_t mask = ((sink.outCount >= 32 ? 0 : (1u << sink.outCount)) - 1) << sink.outBase;
+                    setGpio(mask, value << sink.outBase);
+                    sampleParallel();
+                }
+                else if (sink.attached)
+                {
+                    // narrow writes are replicated across the FIFO word like on the RP2040,
+                    // the spi program shifts the word out MSB first
+                    if (size == 1) value = (value & 0xff) * 0x01010101u;
+                    if (size == 2) value = (value & 0xffff) * 0x00010001u;
+                    uint32_t bits = sink.bits >= 32 ? 32 : sink.bits;
+                    busWrite(gpioState(sink.dcPin), (uint32_t)((uint64_t)value >> (32 - bits)), bits);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void fireIrq(uint num)
+    {
+        if (!s.irqEnabled[num])
+            return;
+        for (irq_handler_t handler : s.handlers[num])
+            handler();
+    }
+
+    void runChannel(uint32_t channel)
+    {
+        dma_channel_state& ch = s.dma[channel];
+        uint32_t size = 1u << ((ch.ctrl & DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) >> DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB);
+        bool incrRead = ch.ctrl & DMA_CH0_CTRL_TRIG_INCR_READ_BITS;
+        bool incrWrite = ch.ctrl & DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS;
+        bool toPeripheral = false;
+
+        const volatile uint8_t* read = (const volatile uint8_t*)ch.read;
+        volatile uint8_t* write = (volatile uint8_t*)ch.write;
+        for (uint32_t i = 0; i < ch.count; i++)
+        {
+            uint32_t value = 0;
+            if (size == 1) value = *read;
+            else if (size == 2) value = *(const volatile uint16_t*)read;
+            else value = *(const volatile uint32_t*)read;
+
+            if (peripheralWrite(write, value, size))
+                toPeripheral = true;
+            else if (size == 1) *write = (uint8_t)value;
+            else if (size == 2) *(volatile uint16_t*)write = (uint16_t)value;
+            else *(volatile uint32_t*)write = value;
+
+            if (incrRead) read += size;
+            if (incrWrite) write += size;
+        }
+
+        s.transfers.push_back({channel, ch.count, size, toPeripheral});
+        ch.read = read;
+        ch.write = write;
+        ch.count = 0;
+        ch.busy = false;
+
+        if (!(ch.ctrl & DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS) && ch.irq0)
+        {
+            ch.irq0Status = true;
+            fireIrq(DMA_IRQ_0);
+        }
+
+        uint32_t chain = (ch.ctrl & DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) >> DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB;
+        if (chain != channel)
+            dma_channel_start(chain);
+    }
+}
+
+mock_panel::mock_panel(uint32_t width, uint32_t height, uint8_t CASET, uint8_t RASET, uint8_t RAMWR)
+{
+    this->width = width;
+    this->height = height;
+    this->CASET = CASET;
+    this->RASET = RASET;
+    this->RAMWR = RAMWR;
+    this->memory.assign(width * height, 0);
+    this->x1 = width - 1;
+    this->y1 = height - 1;
+}
+
+void mock_panel::clear(uint16_t color)
+{
+    this->memory.assign(this->width * this->height, color);
+}
+
+void mock_panel::resetCounters(void)
+{
+    memset(this->commandCount, 0, sizeof(this->commandCount));
+    this->pixelsWritten = 0;
+}
+
+void mock_panel::write(bool dc, uint32_t value, uint32_t bits)
+{
+    if (!dc)
+    {
+        this->command = value & 0xff;
+        this->commandCount[this->command]++;
+        this->parameter = 0;
+        this->pendingByte = -1;
+        if (this->command == this->RAMWR)
+        {
+            this->x = this->x0;
+            this->y = this->y0;
+        }
+        return;
+    }
+
+    if (this->command == this->RAMWR)
+    {
+        if (bits >= 16)
+        {
+            this->pixel(value & 0xffff);
+        }
+        else if (this->pendingByte < 0)
+        {
+            this->pendingByte = value & 0xff;
+        }
+        else
+        {
+            this->pixel((uint16_t)((this->pendingByte << 8) | (value & 0xff)));
+            this->pendingByte = -1;
+        }
+        return;
+    }
+
+    if (this->command != this->CASET && this->command != this->RASET)
+        return;
+
+    if (this->parameter < 4)
+        this->parameters[this->parameter++] = value & 0xff;
+    if (this->parameter < 4)
+        return;
+
+    uint32_t start = (this->parameters[0] << 8) | this->parameters[1];
+    uint32_t end = (this->parameters[2] << 8) | this->parameters[3];
+    if (this->command == this->CASET)
+    {
+        this->x0 = start;
+        this->x1 = end;
+    }
+    else
+    {
+        this->y0 = start;
+        this->y1 = end;
+    }
+}
+
+void mock_panel::pixel(uint16_t value)
+{
+    if (this->x < this->width && this->y < this->height)
+        this->memory[this->x + this->y * this->width] = value;
+    this->pixelsWritten++;
+
+    if (++this->x > this->x1)
+    {
+        this->x = this->x0;
+        if (++this->y > this->y1)
+            this->y = this->y0;
+    }
+}
+
+namespace mock
+{
+    void reset(void)
+    {
+        s = state();
+        memset((void*)mock_spi_hw, 0, sizeof(mock_spi_hw));
+        memset((void*)mock_pio_hw, 0, sizeof(mock_pio_hw));
+    }
+
+    void attachSPI(spi_inst_t* spi, uint32_t dcPin)
+    {
+        s.spi = spi;
+        s.spiDcPin = dcPin;
+    }
+
+    void attach8080(const uint32_t* dataPins, size_t count, uint32_t wrPin, uint32_t dcPin)
+    {
+        s.parallelPins.assign(dataPins, dataPins + count);
+        s.parallelWr = (int32_t)wrPin;
+        s.parallelDc = dcPin;
+    }
+
+    void attachPIO(PIO pio, uint32_t sm, uint32_t dcPin, uint32_t bits)
+    {
+        pio_sink& sink = s.pio[pio_get_index(pio)][sm];
+        sink.attached = true;
+        sink.dcPin = dcPin;
+        sink.bits = bits;
+    }
+
+    void attachPanel(mock_panel* panel)
+    {
+        s.panel = panel;
+    }
+
+    void recordBus(bool enabled)
+    {
+        s.record = enabled;
+    }
+
+    const std::vector<mock_bus_event>& getBusEvents(void)
+    {
+        return s.events;
+    }
+
+    uint64_t getBusBytes(void)
+    {
+        return s.busBytes;
+    }
+
+    void setDeferredDMA(bool deferred)
+    {
+        s.deferred = deferred;
+    }
+
+    uint32_t runPendingDMA(void)
+    {
+        uint32_t retired = 0;
+        while (!s.pending.empty())
+        {
+            uint32_t channel = s.pending.front();
+            s.pending.erase(s.pending.begin());
+            runChannel(channel);
+            retired++;
+        }
+        return retired;
+    }
+
+    const std::vector<mock_dma_transfer>& getDMATransfers(void)
+    {
+        return s.transfers;
+    }
+
+    uint32_t getClaimedDMAChannels(void)
+    {
+        uint32_t claimed = 0;
+        for (const dma_channel_state& ch : s.dma)
+            claimed += ch.claimed;
+        return claimed;
+    }
+
+    uint64_t getSleptTime(void)
+    {
+        return s.slept;
+    }
+
+    void clearRecorders(void)
+    {
+        s.events.clear();
+        s.transfers.clear();
+        s.busBytes = 0;
+    }
+}
+
+extern "C"
+{
+
+// pico/platform.h
+
+void tight_loop_contents(void)
+{
+    // retire one deferred transfer so spin loops make progress
+    if (!s.pending.empty())
+    {
+        uint32_t channel = s.pending.front();
+        s.pending.erase(s.pending.begin());
+        runChannel(channel);
+    }
+}
+
+uint get_core_num(void)
+{
+    return mockCore;
+}
+
+// pico/time.h
+
+void sleep_ms(uint32_t ms)
+{
+    s.slept += (uint64_t)ms * 1000;
+}
+
+void sleep_us(uint64_t us)
+{
+    s.slept += us;
+}
+
+uint64_t time_us_64(void)
+{
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() + s.slept;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)time_us_64();
+}
+
+// pico/stdlib.h
+
+bool stdio_init_all(void)
+{
+    return true;
+}
+
+// hardware/gpio.h
+
+void gpio_init(uint gpio)
+{
+    setGpio(1u << gpio, 0);
+    s.gpioDir &= ~(1u << gpio);
+}
+
+void gpio_init_mask(uint32_t gpio_mask)
+{
+    setGpio(gpio_mask, 0);
+    s.gpioDir &= ~gpio_mask;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+    if (out) s.gpioDir |= 1u << gpio;
+    else s.gpioDir &= ~(1u << gpio);
+}
+
+void gpio_set_dir_out_masked(uint32_t mask)
+{
+    s.gpioDir |= mask;
+}
+
+void gpio_put(uint gpio, bool value)
+{
+    setGpio(1u << gpio, (uint32_t)value << gpio);
+}
+
+void gpio_put_masked(uint32_t mask, uint32_t value)
+{
+    setGpio(mask, value);
+}
+
+void gpio_put_all(uint32_t value)
+{
+    setGpio(0xffffffffu, value);
+}
+
+bool gpio_get(uint gpio)
+{
+    return gpioState(gpio);
+}
+
+void gpio_pull_up(uint gpio)
+{
+    (void)gpio;
+}
+
+void gpio_pull_down(uint gpio)
+{
+    (void)gpio;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback)
+{
+    (void)gpio;
+    (void)event_mask;
+    (void)enabled;
+    (void)callback;
+}
+
+// hardware/clocks.h
+
+uint32_t clock_get_hz(enum clock_index clk_index)
+{
+    return clk_index == clk_sys ? 125000000u : 12000000u;
+}
+
+// hardware/irq.h
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler)
+{
+    s.handlers[num].assign(1, handler);
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority)
+{
+    (void)order_priority;
+    s.handlers[num].push_back(handler);
+}
+
+void irq_remove_handler(uint num, irq_handler_t handler)
+{
+    std::vector<irq_handler_t>& handlers = s.handlers[num];
+    for (auto it = handlers.begin(); it != handlers.end(); it++)
+    {
+        if (*it == handler)
+        {
+            handlers.erase(it);
+            return;
+        }
+    }
+}
+
+void irq_set_enabled(uint num, bool enabled)
+{
+    s.irqEnabled[num] = enabled;
+}
+
+// hardware/spi.h
+
+uint spi_init(spi_inst_t* spi, uint baudrate)
+{
+    (void)spi;
+    return baudrate;
+}
+
+void spi_set_format(spi_inst_t* spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order)
+{
+    (void)cpol;
+    (void)cpha;
+    (void)order;
+    if (spi == s.spi)
+        s.spiBits = data_bits;
+}
+
+int spi_write_blocking(spi_inst_t* spi, const uint8_t* src, size_t len)
+{
+    if (spi == s.spi)
+    {
+        for (size_t i = 0; i < len; i++)
+            busWrite(gpioState(s.spiDcPin), src[i], 8);
+    }
+    return (int)len;
+}
+
+int spi_write16_blocking(spi_inst_t* spi, const uint16_t* src, size_t len)
+{
+    if (spi == s.spi)
+    {
+        for (size_t i = 0; i < len; i++)
+            busWrite(gpioState(s.spiDcPin), src[i], 16);
+    }
+    return (int)len;
+}
+
+bool spi_is_busy(const spi_inst_t* spi)
+{
+    (void)spi;
+    return false;
+}
+
+bool spi_is_readable(const spi_inst_t* spi)
+{
+    (void)spi;
+    return false;
+}
+
+// hardware/dma.h
+
+int dma_claim_unused_channel(bool required)
+{
+    for (uint32_t i = 0; i < NUM_DMA_CHANNELS; i++)
+    {
+        if (!s.dma[i].claimed)
+        {
+            s.dma[i].claimed = true;
+            return (int)i;
+        }
+    }
+    if (required)
+        abort();
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel)
+{
+    s.dma[channel].claimed = false;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel)
+{
+    dma_channel_config c = {0};
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, DREQ_FORCE);
+    channel_config_set_chain_to(&c, channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_enable(&c, true);
+    return c;
+}
+
+dma_channel_config dma_get_channel_config(uint channel)
+{
+    dma_channel_config c = {s.dma[channel].ctrl};
+    return c;
+}
+
+void dma_channel_set_config(uint channel, const dma_channel_config* config, bool trigger)
+{
+    s.dma[channel].ctrl = config->ctrl;
+    if (trigger) dma_channel_start(channel);
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void* read_addr, bool trigger)
+{
+    s.dma[channel].read = read_addr;
+    if (trigger) dma_channel_start(channel);
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void* write_addr, bool trigger)
+{
+    s.dma[channel].write = write_addr;
+    if (trigger) dma_channel_start(channel);
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger)
+{
+    s.dma[channel].count = trans_count;
+    if (trigger) dma_channel_start(channel);
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config* config, volatile void* write_addr,
+    const volatile void* read_addr, uint transfer_count, bool trigger)
+{
+    dma_channel_set_read_addr(channel, read_addr, false);
+    dma_channel_set_write_addr(channel, write_addr, false);
+    dma_channel_set_trans_count(channel, transfer_count, false);
+    dma_channel_set_config(channel, config, trigger);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void* read_addr, uint32_t transfer_count)
+{
+    s.dma[channel].read = read_addr;
+    s.dma[channel].count = transfer_count;
+    dma_channel_start(channel);
+}
+
+void dma_channel_transfer_to_buffer_now(uint channel, volatile void* write_addr, uint32_t transfer_count)
+{
+    s.dma[channel].write = write_addr;
+    s.dma[channel].count = transfer_count;
+    dma_channel_start(channel);
+}
+
+void dma_channel_start(uint channel)
+{
+    s.dma[channel].busy = true;
+    if (s.deferred)
+        s.pending.push_back(channel);
+    else
+        runChannel(channel);
+}
+
+void dma_channel_abort(uint channel)
+{
+    for (auto it = s.pending.begin(); it != s.pending.end(); it++)
+    {
+        if (*it == channel)
+        {
+            s.pending.erase(it);
+            break;
+        }
+    }
+    s.dma[channel].busy = false;
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+    return s.dma[channel].busy;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel)
+{
+    while (s.dma[channel].busy)
+        tight_loop_contents();
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled)
+{
+    s.dma[channel].irq0 = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel)
+{
+    return s.dma[channel].irq0Status;
+}
+
+void dma_channel_acknowledge_irq0(uint channel)
+{
+    s.dma[channel].irq0Status = false;
+}
+
+// hardware/pio.h
+
+pio_sm_config pio_get_default_sm_config(void)
+{
+    pio_sm_config c = {};
+    c.clk_div = 1.0f;
+    c.pull_threshold = 32;
+    return c;
+}
+
+void sm_config_set_out_pins(pio_sm_config* c, uint out_base, uint out_count)
+{
+    c->out_base = out_base;
+    c->out_count = out_count;
+}
+
+void sm_config_set_set_pins(pio_sm_config* c, uint set_base, uint set_count)
+{
+    (void)c;
+    (void)set_base;
+    (void)set_count;
+}
+
+void sm_config_set_sideset_pins(pio_sm_config* c, uint sideset_base)
+{
+    c->sideset_base = sideset_base;
+}
+
+void sm_config_set_sideset(pio_sm_config* c, uint bit_count, bool optional, bool pindirs)
+{
+    (void)pindirs;
+    c->sideset_bit_count = bit_count;
+    c->sideset_optional = optional;
+}
+
+void sm_config_set_wrap(pio_sm_config* c, uint wrap_target, uint wrap)
+{
+    c->execctrl = (wrap_target << 7) | (wrap << 12);
+}
+
+void sm_config_set_clkdiv(pio_sm_config* c, float div)
+{
+    c->clk_div = div;
+}
+
+void sm_config_set_out_shift(pio_sm_config* c, bool shift_right, bool autopull, uint pull_threshold)
+{
+    c->out_shift_right = shift_right;
+    c->autopull = autopull;
+    c->pull_threshold = pull_threshold;
+}
+
+void sm_config_set_fifo_join(pio_sm_config* c, enum pio_fifo_join join)
+{
+    (void)c;
+    (void)join;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t* program)
+{
+    uint32_t index = pio_get_index(pio);
+    uint offset = s.programOffset[index];
+    s.programOffset[index] += program->length;
+    return offset;
+}
+
+void pio_remove_program(PIO pio, const pio_program_t* program, uint loaded_offset)
+{
+    (void)pio;
+    (void)program;
+    (void)loaded_offset;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required)
+{
+    uint32_t index = pio_get_index(pio);
+    for (uint32_t sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++)
+    {
+        if (!(s.smClaimed[index] & (1u << sm)))
+        {
+            s.smClaimed[index] |= 1u << sm;
+            return (int)sm;
+        }
+    }
+    if (required)
+        abort();
+    return -1;
+}
+
+void pio_sm_unclaim(PIO pio, uint sm)
+{
+    s.smClaimed[pio_get_index(pio)] &= ~(1u << sm);
+}
+
+void pio_gpio_init(PIO pio, uint pin)
+{
+    (void)pio;
+    (void)pin;
+}
+
+int pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config* config)
+{
+    (void)initial_pc;
+    pio_sm_set_config(pio, sm, config);
+    return 0;
+}
+
+void pio_sm_set_config(PIO pio, uint sm, const pio_sm_config* config)
+{
+    pio_sink& sink = s.pio[pio_get_index(pio)][sm];
+    sink.outBase = config->out_base;
+    sink.outCount = config->out_count;
+    sink.sidesetBase = config->sideset_base;
+
+    pio->sm[sm].execctrl = config->execctrl;
+    pio->sm[sm].shiftctrl = (config->autopull ? PIO_SM0_SHIFTCTRL_AUTOPULL_BITS : 0)
+        | (config->out_shift_right ? PIO_SM0_SHIFTCTRL_OUT_SHIFTDIR_BITS : 0)
+        | ((config->pull_threshold & 0x1f) << PIO_SM0_SHIFTCTRL_PULL_THRESH_LSB);
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled)
+{
+    if (enabled) pio->ctrl = pio->ctrl | (1u << sm);
+    else pio->ctrl = pio->ctrl & ~(1u << sm);
+}
+
+void pio_sm_restart(PIO pio, uint sm)
+{
+    (void)pio;
+    (void)sm;
+}
+
+void pio_sm_clear_fifos(PIO pio, uint sm)
+{
+    (void)pio;
+    (void)sm;
+}
+
+void pio_sm_exec(PIO pio, uint sm, uint instr)
+{
+    pio->sm[sm].instr = instr;
+
+    // the spi program keeps its bit count in Y
+    pio_sink& sink = s.pio[pio_get_index(pio)][sm];
+    if (sink.attached && (instr & 0xffe0u) == pio_encode_set(pio_y, 0))
+        sink.bits = (instr & 0x1fu) + 2;
+}
+
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out)
+{
+    (void)pio;
+    (void)sm;
+    uint32_t mask = (pin_count >= 32 ? 0xffffffffu : ((1u << pin_count) - 1)) << pin_base;
+    if (is_out) s.gpioDir |= mask;
+    else s.gpioDir &= ~mask;
+}
+
+void pio_sm_set_pins_with_mask(PIO pio, uint sm, uint32_t pin_values, uint32_t pin_mask)
+{
+    (void)pio;
+    (void)sm;
+    setGpio(pin_mask, pin_values);
+}
+
+void pio_sm_set_pindirs_with_mask(PIO pio, uint sm, uint32_t pin_dirs, uint32_t pin_mask)
+{
+    (void)pio;
+    (void)sm;
+    s.gpioDir = (s.gpioDir & ~pin_mask) | (pin_dirs & pin_mask);
+}
+
+void pio_sm_put(PIO pio, uint sm, uint32_t data)
+{
+    peripheralWrite(&pio->txf[sm], data, 4);
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data)
+{
+    peripheralWrite(&pio->txf[sm], data, 4);
+}
+
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm)
+{
+    (void)pio;
+    (void)sm;
+    return false;
+}
+
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm)
+{
+    (void)pio;
+    (void)sm;
+    return true;
+}
+
+}
+
+
+extern "C"
+{
+
+// pico/multicore.h
+
+void multicore_launch_core1(void (*entry)(void))
+{
+    multicore_reset_core1();
+    multicore_fifo_drain();
+    core1 = std::thread([entry]() {
+        mockCore = 1;
+        entry();
+    });
+}
+
+void multicore_reset_core1(void)
+{
+    if (core1.joinable())
+        core1.join();
+}
+
+bool multicore_fifo_rvalid(void)
+{
+    std::lock_guard<std::mutex> lock(fifoLock);
+    return !fifo[mockCore].empty();
+}
+
+bool multicore_fifo_wready(void)
+{
+    std::lock_guard<std::mutex> lock(fifoLock);
+    return fifo[mockCore ^ 1].size() < fifoDepth;
+}
+
+void multicore_fifo_push_blocking(uint32_t data)
+{
+    std::unique_lock<std::mutex> lock(fifoLock);
+    std::deque<uint32_t>& queue = fifo[mockCore ^ 1];
+    fifoChanged.wait(lock, [&queue]() { return queue.size() < fifoDepth; });
+    queue.push_back(data);
+    fifoChanged.notify_all();
+}
+
+uint32_t multicore_fifo_pop_blocking(void)
+{
+    std::unique_lock<std::mutex> lock(fifoLock);
+    std::deque<uint32_t>& queue = fifo[mockCore];
+    fifoChanged.wait(lock, [&queue]() { return !queue.empty(); });
+    uint32_t data = queue.front();
+    queue.pop_front();
+    fifoChanged.notify_all();
+    return data;
+}
+
+void multicore_fifo_drain(void)
+{
+    std::lock_guard<std::mutex> lock(fifoLock);
+    fifo[mockCore].clear();
+    fifoChanged.notify_all();
+}
+
+}
\ No newline at end of file
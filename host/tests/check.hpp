@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdio.h>
+#include "mock/mock.hpp"
+#include "display_struct.h"
+
+// Minimal test helpers, every failed check is printed and fails the test
+inline int checkFailures = 0;
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+        checkFailures++; \
+    } \
+} while (0)
+
+#define RUN(test) do { printf("%s\n", #test); test(); } while (0)
+
+// Pins the mock decodes the bus with
+#define TEST_DC_PIN 16
+
+/**
+ * @brief Configuration of a small SPI display
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param pio True to drive the bus from PIO
+*/
+inline display_config_t spiConfig(uint32_t width, uint32_t height, bool pio = false)
+{
+    display_config_t config = {
+        .backlightPin = -1, .height = height, .width = width,
+        .columnOffset1 = 0, .columnOffset2 = 0, .rowOffset1 = 0, .rowOffset2 = 0,
+        .rotation = ROTATION_0, .interface = DISPLAY_SPI,
+        .spi = { .rst = 20, .dc = TEST_DC_PIN, .cs = 17, .sda = 19, .scl = 18, 
+            .pio = pio, .spi_instance = spi0, .baudrate = 62500000 },
+    };
+    return config;
+}
+
+/**
+ * @brief Check that the panel shows what is in a frame buffer
+ * @param panel Panel to check
+ * @param frameBuffer Buffer the panel should match
+ * @param width Width of the buffer
+ * @param height Height of the buffer
+ * @return int Number of pixels that differ
+*/
+inline int countMismatches(mock_panel& panel, const uint16_t* frameBuffer, uint32_t width, uint32_t height)
+{
+    int mismatches = 0;
+    for (uint32_t y = 0; y < height; y++)
+        for (uint32_t x = 0; x < width; x++)
+            if (panel.getPixel(x, y) != frameBuffer[x + y * width])
+                mismatches++;
+    return mismatches;
+}
@@ -0,0 +1,363 @@
+#include <memory>
+#include "check.hpp"
+#include "st7789.hpp"
+#include "graphics.hpp"
+#include "damage.hpp"
+#include "scene.hpp"
+#include "print.hpp"
+#include "gradient.hpp"
+
+#define WIDTH 45
+#define HEIGHT 61
+
+// Display on the hardware SPI with its panel, set up fresh for every test
+struct spiDisplay
+{
+    display_config_t config = spiConfig(WIDTH, HEIGHT);
+    mock_panel panel = mock_panel(240, 320);
+    std::unique_ptr<hardware_driver> hw;
+    std::unique_ptr<st7789> disp;
+    std::unique_ptr<graphics> gfx;
+
+    spiDisplay()
+    {
+        mock::reset();
+        mock::attachSPI(spi0, TEST_DC_PIN);
+        mock::attachPanel(&this->panel);
+        this->hw = std::make_unique<hardware_driver>(&this->config);
+        this->disp = std::make_unique<st7789>(this->hw.get(), &this->config);
+        this->gfx = std::make_unique<graphics>(this->disp->getFrameBuffer(), &this->config);
+        this->hw->init();
+        this->disp->init();
+        this->disp->attach(this->gfx.get());
+        mock::clearRecorders();
+        this->panel.resetCounters();
+    }
+};
+
+static void initSequence(void)
+{
+    mock::reset();
+    mock_panel panel(240, 320);
+    mock::attachSPI(spi0, TEST_DC_PIN);
+    mock::attachPanel(&panel);
+    display_config_t config = spiConfig(WIDTH, HEIGHT);
+    hardware_driver hw(&config);
+    auto disp = std::make_unique<st7789>(&hw, &config);
+    hw.init();
+    disp->init();
+
+    // reset and sleep out are the only waits
+    CHECK(mock::getSleptTime() == 150000);
+    CHECK(panel.getCommandCount(0x01) == 1);
+    CHECK(panel.getCommandCount(0x11) == 1);
+    CHECK(panel.getCommandCount(0x29) == 1);
+    CHECK(panel.getPixel(0, 0) == 0);
+}
+
+static void parallelBus(void)
+{
+    mock::reset();
+    mock_panel panel(240, 320);
+    display_8080_config_t bus = {
+        .db = { 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 },
+        .db_size = 16, .rst = 18, .csx = 19, .dcx = 21, .rdx = 16, .wrx = 17, .im0 = 20,
+    };
+    display_config_t config = {
+        .dimming = false, .inverseColors = true, .backlightPin = -1, .height = HEIGHT, .width = WIDTH,
+        .columnOffset1 = 0, .columnOffset2 = 0, .rowOffset1 = 0, .rowOffset2 = 0,
+        .rotation = ROTATION_0, .interface = DISPLAY_8080, .b8080 = bus,
+    };
+    mock::attach8080(bus.db, bus.db_size, bus.wrx, bus.dcx);
+    mock::attachPanel(&panel);
+    hardware_driver hw(&config);
+    auto disp = std::make_unique<st7789>(&hw, &config);
+    graphics gfx(disp->getFrameBuffer(), &config);
+    hw.init();
+    disp->init();
+    panel.resetCounters();
+
+    // the reversed data bus undoes the inverted colors
+    gfx.fill(color(255, 0, 0));
+    disp->update();
+    CHECK(panel.getPixelsWritten() == WIDTH * HEIGHT);
+    CHECK(panel.getCommandCount(0x2a) == 1);
+    CHECK(panel.getPixel(5, 5) == 0xf800);
+    CHECK(panel.getPixel(WIDTH - 1, HEIGHT - 1) == 0xf800);
+}
+
+static void fullUpdate(void)
+{
+    spiDisplay d;
+    d.gfx->fill((uint16_t)0x1234);
+    d.gfx->drawFilledCircle({ 20, 30 }, 10, colors::red);
+    d.disp->update();
+
+    CHECK(countMismatches(d.panel, d.disp->getFrameBuffer(), WIDTH, HEIGHT) == 0);
+    CHECK(d.panel.getPixelsWritten() == WIDTH * HEIGHT);
+
+    // one transfer of 16 bit pixels for the whole frame
+    auto& transfers = mock::getDMATransfers();
+    CHECK(transfers.size() == 1);
+    CHECK(transfers.size() == 1 && transfers[0].count == WIDTH * HEIGHT);
+    CHECK(transfers.size() == 1 && transfers[0].size == 2);
+}
+
+static void rectUpdate(void)
+{
+    spiDisplay d;
+    d.disp->update();
+    d.gfx->fill((uint16_t)0xffff);
+    d.panel.resetCounters();
+    d.disp->update(rect(5, 6, 14, 20));
+
+    CHECK(d.panel.getPixelsWritten() == 10 * 15);
+    CHECK(d.panel.getCommandCount(0x2a) == 1);
+    CHECK(d.panel.getCommandCount(0x2b) == 1);
+    CHECK(d.panel.getCommandCount(0x2c) == 1);
+    CHECK(d.panel.getPixel(5, 6) == 0xffff);
+    CHECK(d.panel.getPixel(14, 20) == 0xffff);
+    CHECK(d.panel.getPixel(4, 6) == 0);
+    CHECK(d.panel.getPixel(15, 20) == 0);
+    CHECK(d.panel.getPixel(14, 21) == 0);
+}
+
+static void pioSpi(void)
+{
+    mock::reset();
+    mock_panel panel(240, 320);
+    display_config_t config = spiConfig(WIDTH, HEIGHT, true);
+    mock::attachPIO(pio0, 0, TEST_DC_PIN, 8);
+    mock::attachPanel(&panel);
+    hardware_driver hw(&config);
+    auto disp = std::make_unique<st7789>(&hw, &config);
+    graphics gfx(disp->getFrameBuffer(), &config);
+    hw.init();
+    disp->init();
+    CHECK(panel.getCommandCount(0x29) == 1);
+
+    mock::clearRecorders();
+    mock::recordBus(true);
+    gfx.fill((uint16_t)0x1234);
+    gfx.drawFilledCircle({ 20, 30 }, 10, colors::red);
+    disp->update();
+    CHECK(countMismatches(panel, disp->getFrameBuffer(), WIDTH, HEIGHT) == 0);
+
+    gfx.drawFilledRectangle({ 5, 6 }, { 15, 21 }, colors::blue);
+    panel.resetCounters();
+    disp->update(rect(5, 6, 14, 20));
+    CHECK(panel.getPixelsWritten() == 10 * 15);
+    CHECK(countMismatches(panel, disp->getFrameBuffer(), WIDTH, HEIGHT) == 0);
+
+    // commands and their parameters are bytes, the pixels after RAMWR go out as 16 bits
+    size_t pixels = 0;
+    bool memoryWrite = false;
+    for (const mock_bus_event& event : mock::getBusEvents())
+    {
+        if (!event.dc)
+            memoryWrite = event.value == 0x2c;
+        if (memoryWrite && event.dc)
+        {
+            CHECK(event.bits == 16);
+            pixels++;
+        }
+        else
+            CHECK(event.bits == 8);
+    }
+    CHECK(pixels == WIDTH * HEIGHT + 10 * 15);
+    mock::recordBus(false);
+}
+
+static void damageFlush(void)
+{
+    spiDisplay d;
+    damageTracker damage(&d.config);
+    d.disp->update();
+    d.disp->setDamageTracker(&damage);
+    d.gfx->drawFilledRectangle({ 3, 4 }, { 10, 10 }, colors::green);
+    d.gfx->drawLine({ 20, 20 }, { 30, 25 }, colors::red);
+    d.panel.resetCounters();
+    d.disp->flushDirty();
+
+    CHECK(countMismatches(d.panel, d.disp->getFrameBuffer(), WIDTH, HEIGHT) == 0);
+    CHECK(d.panel.getPixelsWritten() == 7 * 6 + 11 * 6);
+    CHECK(damage.isEmpty());
+}
+
+static void blurDamage(void)
+{
+    spiDisplay d;
+    damageTracker damage(&d.config);
+    for (int32_t x = 0; x < WIDTH; x += 3)
+        d.gfx->drawLine({ x, 0 }, { WIDTH - 1 - x, HEIGHT - 1 }, colors::white);
+    d.disp->update();
+    d.disp->setDamageTracker(&damage);
+    d.gfx->addBlur(rect(5, 6, 25, 36));
+    d.panel.resetCounters();
+    d.disp->flushDirty();
+
+    // only the blurred area changed and only it goes out
+    CHECK(countMismatches(d.panel, d.disp->getFrameBuffer(), WIDTH, HEIGHT) == 0);
+    CHECK(d.panel.getPixelsWritten() == 20 * 30);
+}
+
+static void doubleBuffer(void)
+{
+    spiDisplay d;
+    std::vector<uint16_t> back(WIDTH * HEIGHT);
+    printer text(d.disp->getFrameBuffer(), &d.config);
+    gradient grad(d.disp->getFrameBuffer(), &d.config);
+    d.disp->attach(&text);
+    d.disp->attach(&grad);
+    d.disp->setBackBuffer(back.data());
+    uint16_t* first = d.disp->getFrameBuffer();
+
+    // frame 1 goes out of the first buffer, everything draws into the back buffer next
+    mock::setDeferredDMA(true);
+    d.gfx->fill(colors::red);
+    d.disp->present();
+    CHECK(d.disp->getFrameBuffer() == back.data());
+    CHECK(d.gfx->getFrameBuffer() == back.data());
+    CHECK(text.getFrameBuffer() == back.data());
+    CHECK(grad.getFrameBuffer() == back.data());
+    CHECK(mock::getDMATransfers().empty());
+
+    // frame 2 can only go out once frame 1 has left the buffer that is handed back
+    d.gfx->fill(colors::blue);
+    d.disp->present();
+    CHECK(d.gfx->getFrameBuffer() == first);
+    CHECK(text.getFrameBuffer() == first);
+    CHECK(grad.getFrameBuffer() == first);
+    CHECK(mock::getDMATransfers().size() == 1);
+    CHECK(d.panel.getPixel(0, 0) == colors::red && d.panel.getPixel(WIDTH - 1, HEIGHT - 1) == colors::red);
+
+    // drawing frame 3 does not touch frame 2 on the wire
+    d.gfx->fill(colors::green);
+    mock::runPendingDMA();
+    CHECK(countMismatches(d.panel, back.data(), WIDTH, HEIGHT) == 0);
+    CHECK(d.panel.getPixel(0, 0) == colors::blue);
+    mock::setDeferredDMA(false);
+}
+
+static void frameDiff(void)
+{
+    spiDisplay d;
+    d.disp->setFrameDiff(true);
+    d.disp->update();
+    d.gfx->drawFilledRectangle({ 18, 18 }, { 22, 22 }, colors::blue);
+    d.panel.resetCounters();
+    d.disp->update();
+
+    // only the tile holding the rectangle goes out
+    CHECK(countMismatches(d.panel, d.disp->getFrameBuffer(), WIDTH, HEIGHT) == 0);
+    CHECK(d.panel.getPixelsWritten() == DIFF_TILE_SIZE * DIFF_TILE_SIZE);
+
+    d.panel.resetCounters();
+    d.disp->update();
+    CHECK(d.panel.getPixelsWritten() == 0);
+}
+
+/**
+ * @brief Check that a scene looks the same drawn at once and band by band
+ * @param d Display to draw on
+ * @param s Scene to draw
+*/
+static void checkBands(spiDisplay& d, scene& s)
+{
+    // the whole frame first, then band by band over a cleared panel
+    s.render();
+    d.disp->update();
+    std::vector<uint16_t> expected(d.panel.getMemory(), d.panel.getMemory() + 240 * 320);
+
+    uint16_t strips[2][WIDTH * 8];
+    for (int buffers = 1; buffers <= 2; buffers++)
+    {
+        d.panel.clear();
+        d.disp->setStrips(strips[0], buffers == 2 ? strips[1] : nullptr, 8);
+        d.disp->render(&s);
+        d.disp->waitIdle();
+        CHECK(std::equal(expected.begin(), expected.end(), d.panel.getMemory()));
+    }
+}
+
+static void bandRendering(void)
+{
+    spiDisplay d;
+    scene s(d.gfx.get());
+    point polygon[4] = { { 2, 30 }, { 40, 25 }, { 35, 58 }, { 5, 50 } };
+    s.fill(colors::black);
+    s.drawFilledPolygon(polygon, 4, colors::green);
+    s.drawFilledCircle({ 22, 30 }, 12, colors::yellow);
+    s.drawCircle({ 22, 30 }, 18, colors::white, 3);
+    s.drawLine({ 0, 0 }, { 44, 60 }, colors::cyan);
+    s.drawFilledTriangle({ 3, 3 }, { 20, 15 }, { 8, 28 }, colors::magenta);
+    checkBands(d, s);
+}
+
+static void bandRenderingAntiAliased(void)
+{
+    spiDisplay d;
+    scene s(d.gfx.get());
+    point trace[4] = { { 2, 59 }, { 14, 49 }, { 26, 59 }, { 42, 50 } };
+    s.fill(colors::black);
+
+    // the parts of a dial gauge, the blended edges reach past the shapes
+    s.drawFilledDualArc({ 22, 20 }, 11, 18, 205, 295, colors::green);
+    s.drawFilledDualArcAntiAliased({ 22, 20 }, 11, 18, 295, 335, colors::yellow);
+    s.drawArcAntiAliased({ 22, 20 }, 19, 335, 425, colors::red, 3);
+    s.drawArc({ 22, 20 }, 8, 0, 360, colors::white);
+    s.drawLineThickAntiAliased({ 22, 20 }, { 36, 9 }, 3, colors::white, CapRound);
+    s.drawFilledCircleAntiAliased({ 22, 20 }, 3, colors::white);
+    s.drawCircleAntiAliased({ 22, 20 }, 21, colors::blue, 2);
+
+    s.drawFilledEllipse({ 12, 38 }, 10, 5, colors::magenta);
+    s.drawFilledRoundedRectangle({ 25, 32 }, { 43, 43 }, 4, colors::cyan);
+    s.drawLineAntiAliased({ 0, 60 }, { 44, 31 }, colors::white);
+    s.drawPolyline(trace, 4, 4, colors::red, CapSquare, JoinMiter);
+    checkBands(d, s);
+}
+
+static void sharedDmaInterrupt(void)
+{
+    mock::reset();
+    mock::attachSPI(spi0, TEST_DC_PIN);
+    display_config_t config = spiConfig(WIDTH, HEIGHT);
+    uint16_t pixels[16] = { 0 };
+    {
+        hardware_driver first(&config);
+        hardware_driver second(&config);
+        first.init();
+        second.init();
+        CHECK(mock::getClaimedDMAChannels() == 2);
+
+        // the interrupt is shared, each driver has to see the end of its own transfer
+        mock::setDeferredDMA(true);
+        first.writePixelsAsync(pixels, 16);
+        second.writePixelsAsync(pixels, 16);
+        mock::runPendingDMA();
+        CHECK(!first.isBusy());
+        CHECK(!second.isBusy());
+        CHECK(!dma_channel_get_irq0_status(0));
+        CHECK(!dma_channel_get_irq0_status(1));
+    }
+
+    // the channels go back once the drivers are gone
+    CHECK(mock::getClaimedDMAChannels() == 0);
+}
+
+int main(void)
+{
+    RUN(initSequence);
+    RUN(parallelBus);
+    RUN(fullUpdate);
+    RUN(rectUpdate);
+    RUN(pioSpi);
+    RUN(damageFlush);
+    RUN(blurDamage);
+    RUN(doubleBuffer);
+    RUN(frameDiff);
+    RUN(bandRendering);
+    RUN(bandRenderingAntiAliased);
+    RUN(sharedDmaInterrupt);
+    return checkFailures ? 1 : 0;
+}
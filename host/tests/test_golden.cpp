@@ -0,0 +1,590 @@
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include "check.hpp"
+#include "graphics.hpp"
+#include "gradient.hpp"
+#include "print.hpp"
+#include "gauge.hpp"
+#include "chart.hpp"
+#include "RobotoMono16.font"
+
+// Renders every scene into a frame buffer and compares it to the reference image
+// with the same name, usage: test_golden <reference directory> [--regenerate]
+//
+// References are binary PPM files, RGB565 is expanded to 8 bits per channel by
+// repeating the top bits so every pixel converts back to the exact same value.
+// On a mismatch <name>.actual.ppm and <name>.diff.ppm are written to the working
+// directory, the diff shows the differing pixels in red over a dimmed reference
+
+#define GOLDEN_WIDTH 96
+#define GOLDEN_HEIGHT 96
+#define GOLDEN_PIXELS (GOLDEN_WIDTH * GOLDEN_HEIGHT)
+
+// How many differing pixels are listed before the report is cut short
+#define GOLDEN_REPORT_LIMIT 8
+
+// Everything a scene can draw with, all drawing into the same buffer
+struct goldenContext
+{
+    display_config_t config = { .height = GOLDEN_HEIGHT, .width = GOLDEN_WIDTH };
+    uint16_t frameBuffer[GOLDEN_PIXELS] = { 0 };
+    graphics gfx = graphics(this->frameBuffer, &this->config);
+    gradient grad = gradient(this->frameBuffer, &this->config);
+    printer text = printer(this->frameBuffer, &this->config);
+};
+
+typedef void (*goldenScene_t)(goldenContext& c);
+
+/**
+ * @brief Fill the buffer with a pattern that has detail in every channel
+ * @param c Context to draw in
+*/
+static void drawPattern(goldenContext& c)
+{
+    c.grad.fillGradient(colors::red, colors::blue, point(0, 0), point(GOLDEN_WIDTH - 1, GOLDEN_HEIGHT - 1));
+    for (int32_t i = 0; i < GOLDEN_WIDTH; i += 12)
+        c.gfx.drawLine({ i, 0 }, { GOLDEN_WIDTH - 1 - i, GOLDEN_HEIGHT - 1 }, colors::white);
+    c.gfx.drawFilledCircle({ 48, 48 }, 20, colors::green);
+    c.gfx.drawFilledRectangle({ 10, 60 }, { 40, 85 }, colors::yellow);
+}
+
+static void sceneFill(goldenContext& c)
+{
+    c.gfx.fill(color(40, 80, 120));
+    c.gfx.drawFilledRectangle({ 10, 10 }, { 30, 20 }, colors::orange);
+    c.gfx.drawFilledRectangle({ 60, 50 }, { 96, 96 }, colors::cyan);
+}
+
+static void sceneLines(goldenContext& c)
+{
+    // a fan through every octant, plus the straight and single pixel cases
+    point center = { 48, 48 };
+    for (int32_t i = 0; i <= 80; i += 10)
+    {
+        c.gfx.drawLine(center, { 8 + i, 8 }, colors::white);
+        c.gfx.drawLine(center, { 8 + i, 88 }, colors::red);
+        c.gfx.drawLine(center, { 8, 8 + i }, colors::green);
+        c.gfx.drawLine(center, { 88, 8 + i }, colors::blue);
+    }
+    c.gfx.drawLine({ 0, 0 }, { 95, 0 }, colors::yellow);
+    c.gfx.drawLine({ 0, 95 }, { 0, 0 }, colors::yellow);
+    c.gfx.drawLine({ 90, 5 }, { 90, 5 }, colors::magenta);
+}
+
+static void sceneLinesAntiAliased(goldenContext& c)
+{
+    c.gfx.fill(colors::black);
+    point center = { 48, 48 };
+    for (int32_t i = 0; i <= 80; i += 16)
+    {
+        c.gfx.drawLineAntiAliased(center, { 8 + i, 8 }, colors::white);
+        c.gfx.drawLineAntiAliased(center, { 8 + i, 88 }, colors::red);
+        c.gfx.drawLineAntiAliased(center, { 8, 8 + i }, colors::green);
+        c.gfx.drawLineAntiAliased(center, { 88, 8 + i }, colors::cyan);
+    }
+    c.gfx.drawLineThickAntiAliased({ 10, 70 }, { 85, 90 }, 5, colors::yellow);
+    c.gfx.drawLineThickAntiAliased({ 70, 10 }, { 90, 60 }, 3, colors::orange);
+}
+
+static void scenePolylines(goldenContext& c)
+{
+    c.gfx.fill(colors::black);
+    point zigzag[] = { { 6, 30 }, { 18, 8 }, { 30, 30 }, { 42, 8 }, { 54, 30 } };
+    point miter[] = { { 6, 62 }, { 20, 40 }, { 34, 62 } };
+    point bevel[] = { { 40, 62 }, { 54, 40 }, { 68, 62 } };
+    point spike[] = { { 4, 88 }, { 24, 88 }, { 28, 70 }, { 32, 88 }, { 52, 88 } };
+    point offscreen[] = { { 70, 80 }, { 86, 66 }, { 110, 90 }, { 80, 110 } };
+
+    c.gfx.drawPolyline(zigzag, 5, 5, colors::white, CapRound, JoinRound);
+    c.gfx.drawPolyline(miter, 3, 7, colors::red, CapButt, JoinMiter);
+    c.gfx.drawPolyline(bevel, 3, 7, colors::blue, CapSquare, JoinBevel);
+    c.gfx.drawPolyline(spike, 5, 3, colors::green, CapButt, JoinMiter);
+    c.gfx.drawPolyline(offscreen, 4, 6, colors::magenta, CapRound, JoinRound);
+    c.gfx.drawLineThickAntiAliased({ 66, 8 }, { 88, 36 }, 6, colors::yellow, CapRound);
+    c.gfx.drawLineThickAntiAliased({ 60, 44 }, { 92, 44 }, 2, colors::cyan);
+}
+
+static void sceneTriangles(goldenContext& c)
+{
+    // outlines over the filled ones show where the edge coverage disagrees
+    point triangles[][3] = {
+        { { 5, 5 }, { 45, 12 }, { 15, 40 } },
+        { { 90, 5 }, { 55, 40 }, { 88, 44 } },
+        { { 10, 90 }, { 30, 50 }, { 45, 90 } },
+        { { 50, 60 }, { 92, 60 }, { 70, 92 } },
+        { { 48, 30 }, { 49, 30 }, { 48, 55 } },
+    };
+    for (auto& t : triangles)
+    {
+        c.gfx.drawFilledTriangle(t[0], t[1], t[2], colors::blue);
+        c.gfx.drawTriangle(t[0], t[1], t[2], colors::white);
+    }
+}
+
+static void sceneRectangles(goldenContext& c)
+{
+    c.gfx.drawFilledRectangle({ 5, 5 }, { 40, 30 }, colors::red);
+    c.gfx.drawRectangle({ 5, 5 }, { 40, 30 }, colors::white);
+    c.gfx.drawRectangle(rect(50, 5, 90, 45), colors::green);
+    c.gfx.drawRectangle(point(48, 70), 30, 20, colors::yellow);
+    c.gfx.drawFilledRectangle({ 60, 80 }, { 80, 90 }, colors::cyan);
+    c.gfx.drawRectangle({ -10, 60 }, { 20, 110 }, colors::magenta);
+}
+
+static void scenePolygons(goldenContext& c)
+{
+    point convex[] = { { 10, 5 }, { 40, 5 }, { 45, 25 }, { 25, 40 }, { 5, 25 } };
+    point concave[] = { { 55, 5 }, { 90, 5 }, { 90, 40 }, { 72, 20 }, { 55, 40 } };
+    point star[] = { { 48, 50 }, { 55, 68 }, { 92, 70 }, { 60, 78 }, { 70, 94 }, { 48, 84 }, { 26, 94 }, { 36, 78 }, { 4, 70 }, { 41, 68 } };
+
+    c.gfx.drawFilledPolygon(convex, 5, colors::blue);
+    c.gfx.drawPolygon(convex, 5, colors::white);
+    c.gfx.drawFilledPolygon(concave, 5, colors::red);
+    c.gfx.drawPolygon(concave, 5, colors::yellow);
+    c.gfx.drawFilledPolygon(star, 10, colors::green);
+    c.gfx.drawPolygon(star, 10, colors::white);
+}
+
+static void scenePolygonRules(goldenContext& c)
+{
+    // a pentagram has a center the outline winds around twice, a ring has a hole wound the other way
+    point pentagram[] = { { 24, 4 }, { 37, 44 }, { 3, 19 }, { 45, 19 }, { 11, 44 } };
+    point ring[] = { { 52, 50 }, { 92, 50 }, { 92, 92 }, { 52, 92 }, { 52, 50 }, { 62, 60 }, { 62, 82 }, { 82, 82 }, { 82, 60 }, { 62, 60 } };
+    point shifted[5];
+    for (size_t i = 0; i < 5; i++)
+        shifted[i] = pentagram[i] + point(48, 0);
+    point lowered[10];
+    for (size_t i = 0; i < 10; i++)
+        lowered[i] = ring[i] - point(48, 0);
+
+    c.gfx.drawFilledPolygon(pentagram, 5, colors::orange, FillNonZero);
+    c.gfx.drawFilledPolygon(shifted, 5, colors::orange, FillEvenOdd);
+    c.gfx.drawFilledPolygon(lowered, 10, colors::cyan, FillNonZero);
+    c.gfx.drawFilledPolygon(ring, 10, colors::cyan, FillEvenOdd);
+}
+
+static void scenePolygonLarge(goldenContext& c)
+{
+    // a toothed bezel with more edges than the edge table holds, and a comb with more on a single row
+    point bezel[96];
+    for (int32_t i = 0; i < 96; i++)
+    {
+        int32_t radius = i % 2 ? 30 : 40;
+        bezel[i] = point(48 + ((radius * icos(i * 360 / 96)) >> FIXED_POINT_SCALE_BITS), 40 + ((radius * isin(i * 360 / 96)) >> FIXED_POINT_SCALE_BITS));
+    }
+    point comb[82];
+    for (int32_t i = 0; i < 80; i++)
+        comb[i] = point(4 + i * 88 / 79, i % 2 ? 92 : 72);
+    comb[80] = point(92, 94);
+    comb[81] = point(4, 94);
+
+    c.gfx.drawFilledPolygon(bezel, 96, colors::orange);
+    c.gfx.drawFilledCircle({ 48, 40 }, 20, colors::black);
+    c.gfx.drawFilledPolygon(comb, 82, colors::cyan, FillEvenOdd);
+}
+
+static void sceneCircles(goldenContext& c)
+{
+    c.gfx.drawCircle({ 20, 20 }, 15, colors::white);
+    c.gfx.drawCircle({ 70, 20 }, 18, colors::red, 4);
+    c.gfx.drawFilledCircle({ 20, 70 }, 16, colors::green);
+    c.gfx.drawFilledCircle({ 48, 48 }, 0, colors::white);
+    c.gfx.drawFilledCircleWithStroke({ 70, 70 }, 18, colors::blue, colors::yellow, 3);
+}
+
+static void sceneArcs(goldenContext& c)
+{
+    c.gfx.drawArc({ 48, 48 }, 44, 0, 120, colors::white);
+    c.gfx.drawArc({ 48, 48 }, 40, 200, 340, colors::red);
+    c.gfx.drawFilledDualArc({ 48, 48 }, 20, 34, 30, 150, colors::green);
+    c.gfx.drawFilledDualArc({ 48, 48 }, 10, 30, 270, 45, colors::blue);
+}
+
+static void sceneCirclesAntiAliased(goldenContext& c)
+{
+    c.gfx.drawCircleAntiAliased({ 20, 20 }, 15, colors::white);
+    c.gfx.drawCircleAntiAliased({ 70, 20 }, 18, colors::red, 4);
+    c.gfx.drawFilledCircleAntiAliased({ 20, 70 }, 16, colors::green);
+    c.gfx.drawFilledCircleAntiAliased({ 48, 48 }, 2, colors::white);
+    c.gfx.drawArcAntiAliased({ 70, 70 }, 20, 200, 20, colors::yellow, 3);
+    c.gfx.drawFilledDualArcAntiAliased({ 70, 70 }, 8, 16, 30, 150, colors::blue);
+    c.gfx.drawFilledDualArcAntiAliased({ 90, 4 }, 6, 14, 0, 360, colors::cyan);
+}
+
+static void sceneEllipses(goldenContext& c)
+{
+    c.gfx.drawFilledEllipse({ 30, 20 }, 26, 12, colors::red);
+    c.gfx.drawFilledEllipse({ 80, 40 }, 8, 30, colors::green);
+    c.gfx.drawFilledEllipse({ 20, 50 }, 0, 6, colors::white);
+    c.gfx.drawFilledEllipse({ 90, 90 }, 20, 14, colors::orange);
+    c.gfx.drawFilledRoundedRectangle({ 4, 38 }, { 60, 70 }, 8, colors::blue);
+    c.gfx.drawFilledRoundedRectangle({ 10, 74 }, { 40, 92 }, 30, colors::cyan);
+    c.gfx.drawFilledRoundedRectangle({ 46, 76 }, { 70, 90 }, 0, colors::yellow);
+    c.gfx.drawFilledRoundedRectangle({ 30, 44 }, { 66, 56 }, 3, colors::white);
+}
+
+static void sceneBitmap(goldenContext& c)
+{
+    static uint16_t bitmap[32 * 24];
+    for (uint32_t i = 0; i < 32 * 24; i++)
+        bitmap[i] = (uint16_t)(i * 2654435761u >> 16);
+
+    c.gfx.fill(color(128, 128, 128));
+    c.gfx.drawBitmap(bitmap, 32, 24, point(4, 6));
+    c.gfx.drawBitmap(bitmap, 32, 24, true);
+    c.gfx.drawBitmap((const uint8_t*)bitmap, 16, 16, point(70, 70));
+}
+
+static void sceneBlend(goldenContext& c)
+{
+    static uint16_t bitmap[32 * 32];
+    static uint8_t mask[32 * 32];
+    for (uint32_t y = 0; y < 32; y++)
+    {
+        for (uint32_t x = 0; x < 32; x++)
+        {
+            bitmap[y * 32 + x] = color(x, y * 2, 31 - x).to16bit(false);
+            // a disc that fades out towards its edge
+            int32_t dx = (int32_t)x - 16;
+            int32_t dy = (int32_t)y - 16;
+            int32_t distance = isqrt(dx * dx + dy * dy);
+            mask[y * 32 + x] = distance >= 16 ? 0 : 255 - distance * 16;
+        }
+    }
+
+    drawPattern(c);
+    c.gfx.fill(colors::black, 64);
+    c.gfx.drawTranslucentRectangle(point(-8, 10), point(50, 40), colors::red, 128);
+    c.gfx.drawTranslucentRectangle(point(31, 25), point(90, 55), colors::blue, 200);
+    c.gfx.drawBitmap(bitmap, 32, 32, point(5, 55), 96);
+    c.gfx.drawBitmapMasked(bitmap, mask, 32, 32, point(55, 57));
+    c.gfx.drawBitmapMasked(bitmap, mask, 32, 32, point(80, -10));
+}
+
+static void sceneClip(goldenContext& c)
+{
+    static uint16_t bitmap[32 * 32];
+    for (uint32_t i = 0; i < 32 * 32; i++)
+        bitmap[i] = (uint16_t)(i * 2654435761u >> 16);
+    point star[5] = { { 48, 2 }, { 60, 40 }, { 94, 40 }, { 66, 60 }, { 80, 94 } };
+
+    c.gfx.fill(colors::black);
+    c.gfx.pushClip(rect(8, 8, 88, 88));
+    c.gfx.fill(color(4, 8, 12));
+    c.gfx.pushClip(point(20, 16), point(76, 80));
+    c.gfx.fill(color(8, 16, 8));
+    c.gfx.drawFilledRectangle({ -10, 10 }, { 30, 30 }, colors::orange);
+    c.gfx.drawFilledCircle({ 70, 20 }, 14, colors::red);
+    c.gfx.drawCircle({ 48, 48 }, 36, colors::white);
+    c.gfx.drawCircle({ 48, 48 }, 30, colors::cyan, 4);
+    c.gfx.drawFilledTriangle({ 0, 90 }, { 40, 40 }, { 96, 70 }, colors::green);
+    c.gfx.drawFilledPolygon(star, 5, colors::yellow);
+    c.gfx.drawLine({ 0, 0 }, { 95, 95 }, colors::white);
+    c.gfx.drawLine({ 0, 95 }, { 95, 0 }, colors::magenta);
+    c.gfx.drawLine({ 30, -40 }, { 42, 140 }, colors::orange);
+    c.gfx.drawLine({ 64, -10 }, { 64, 200 }, colors::cyan);
+    c.gfx.drawLine({ -100, 70 }, { 300, 70 }, colors::cyan);
+    c.gfx.drawBitmap(bitmap, 32, 32, point(60, 60));
+    c.gfx.drawFilledDualArc({ 20, 76 }, 8, 16, 0, 270, colors::blue);
+    c.gfx.popClip();
+    c.gfx.drawArc({ 48, 48 }, 44, 0, 360, colors::purple);
+    c.gfx.popClip();
+    c.gfx.drawLine({ 0, 48 }, { 95, 48 }, colors::white);
+}
+
+static void sceneBayer(goldenContext& c)
+{
+    drawPattern(c);
+    c.gfx.addBayerFilter();
+}
+
+static void sceneDithering(goldenContext& c)
+{
+    drawPattern(c);
+    c.gfx.addFloydSteinbergDithering();
+}
+
+static void sceneAntiAliasing(goldenContext& c)
+{
+    drawPattern(c);
+    c.gfx.addAntiAliasingFilter();
+}
+
+static void sceneBlur(goldenContext& c)
+{
+    drawPattern(c);
+    c.gfx.addBlur();
+}
+
+static void sceneBlurArea(goldenContext& c)
+{
+    drawPattern(c);
+    c.gfx.addBlur(rect(20, 20, 70, 60));
+}
+
+// every gradient covers the whole display
+static void sceneGradient(goldenContext& c)
+{
+    c.grad.fillGradient(colors::blue, colors::green, point(10, 35), point(60, 95));
+}
+
+static void sceneGradientCircle(goldenContext& c)
+{
+    c.grad.drawRotCircleGradient({ 48, 48 }, 40, 45, colors::white, colors::magenta);
+}
+
+static void sceneGradientRect(goldenContext& c)
+{
+    c.grad.drawRotRectGradient({ 48, 48 }, 80, 40, 30, colors::cyan, colors::black);
+}
+
+static void sceneText(goldenContext& c)
+{
+    c.gfx.fill(colors::navy);
+    c.text.setFont(&RobotoMono16);
+    c.text.setColor(colors::white);
+    c.text.setCursor({ 2, 2 });
+    c.text.print("Hello\n%d px", 96);
+
+    c.text.setColor(colors::yellow);
+    c.text.setString("gfx");
+    c.text.setCursor({ 0, 70 });
+    c.text.center(Alignment_t::HorizontalCenter);
+    c.text.print();
+}
+
+static void sceneGauge(goldenContext& c)
+{
+    color valueColors[] = { colors::green, colors::yellow, colors::red };
+    dialGauge gauge(&c.gfx, GOLDEN_WIDTH, GOLDEN_HEIGHT, { 48, 48 }, 44, 0, 100, valueColors, 3, DialSimple);
+    gauge.setNeedleColor(colors::white);
+    gauge.update(65);
+}
+
+static void sceneScroll(goldenContext& c)
+{
+    drawPattern(c);
+    c.gfx.scroll({ 8, 8 }, { 56, 56 }, -10, 6);
+    c.gfx.scroll({ 40, 40 }, { 90, 90 }, 7, -5);
+    c.gfx.pushClip(rect(60, 4, 92, 36));
+    c.gfx.scroll({ 50, 0 }, { 96, 40 }, 0, 9);
+    c.gfx.popClip();
+}
+
+/**
+ * @brief Push a sine and a noisy square wave into two charts
+ * @param c Context to draw in
+ * @param step Number of samples between updates, 0 to draw the charts once at the end
+*/
+static void drawCharts(goldenContext& c, uint32_t step)
+{
+    lineChart sine(&c.gfx, { 4, 4 }, { 92, 44 }, -100, 100);
+    sine.setColor(colors::cyan);
+    sine.setAntiAliasing(true);
+    lineChart square(&c.gfx, { 4, 52 }, { 92, 92 }, 0, 255, 4);
+    square.setColor(colors::yellow);
+    square.setBackgroundColor(color(0, 0, 40));
+
+    for (uint32_t i = 0; i < 500; i++)
+    {
+        if (i < 200)
+            sine.push((isin(i * 7) * 90) >> FIXED_POINT_SCALE_BITS);
+        square.push((i / 40 % 2 ? 200 : 60) + (int32_t)((i * 2654435761u) >> 27) - 16);
+        if (step != 0 && i % step == 0)
+        {
+            sine.update();
+            square.update();
+        }
+    }
+
+    if (step == 0)
+    {
+        sine.draw();
+        square.draw();
+    }
+    else
+    {
+        sine.update();
+        square.update();
+    }
+}
+
+static void sceneChart(goldenContext& c)
+{
+    // scrolling a few columns at a time has to end up the same as drawing everything at once
+    drawCharts(c, 3);
+    auto whole = std::make_unique<goldenContext>();
+    drawCharts(*whole, 0);
+    CHECK(memcmp(c.frameBuffer, whole->frameBuffer, sizeof(c.frameBuffer)) == 0);
+}
+
+static const struct
+{
+    const char* name;
+    goldenScene_t scene;
+} scenes[] = {
+    { "fill", sceneFill },
+    { "lines", sceneLines },
+    { "lines_antialiased", sceneLinesAntiAliased },
+    { "polylines", scenePolylines },
+    { "triangles", sceneTriangles },
+    { "rectangles", sceneRectangles },
+    { "polygons", scenePolygons },
+    { "polygon_rules", scenePolygonRules },
+    { "polygon_large", scenePolygonLarge },
+    { "circles", sceneCircles },
+    { "arcs", sceneArcs },
+    { "circles_antialiased", sceneCirclesAntiAliased },
+    { "ellipses", sceneEllipses },
+    { "bitmap", sceneBitmap },
+    { "blend", sceneBlend },
+    { "clip", sceneClip },
+    { "filter_bayer", sceneBayer },
+    { "filter_dithering", sceneDithering },
+    { "filter_antialiasing", sceneAntiAliasing },
+    { "filter_blur", sceneBlur },
+    { "filter_blur_area", sceneBlurArea },
+    { "gradient", sceneGradient },
+    { "gradient_circle", sceneGradientCircle },
+    { "gradient_rect", sceneGradientRect },
+    { "text", sceneText },
+    { "gauge", sceneGauge },
+    { "scroll", sceneScroll },
+    { "chart", sceneChart },
+};
+
+/**
+ * @brief Write an image as a binary PPM
+ * @param path File to write
+ * @param pixels RGB565 pixels
+ * @return bool True if the file was written
+*/
+static bool writePPM(const std::string& path, const uint16_t* pixels)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    fprintf(file, "P6\n%d %d\n255\n", GOLDEN_WIDTH, GOLDEN_HEIGHT);
+    for (uint32_t i = 0; i < GOLDEN_PIXELS; i++)
+    {
+        uint8_t r = (pixels[i] >> 11) & 0x1f;
+        uint8_t g = (pixels[i] >> 5) & 0x3f;
+        uint8_t b = pixels[i] & 0x1f;
+        uint8_t rgb[3] = { (uint8_t)(r << 3 | r >> 2), (uint8_t)(g << 2 | g >> 4), (uint8_t)(b << 3 | b >> 2) };
+        fwrite(rgb, 1, 3, file);
+    }
+    return fclose(file) == 0;
+}
+
+/**
+ * @brief Read a binary PPM written by writePPM
+ * @param path File to read
+ * @param pixels Buffer for the RGB565 pixels
+ * @return bool True if the file exists and has the expected size
+*/
+static bool readPPM(const std::string& path, uint16_t* pixels)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    int width = 0, height = 0, maxValue = 0;
+    bool valid = fscanf(file, "P6 %d %d %d", &width, &height, &maxValue) == 3 && fgetc(file) != EOF
+        && width == GOLDEN_WIDTH && height == GOLDEN_HEIGHT && maxValue == 255;
+    for (uint32_t i = 0; valid && i < GOLDEN_PIXELS; i++)
+    {
+        uint8_t rgb[3];
+        valid = fread(rgb, 1, 3, file) == 3;
+        pixels[i] = (rgb[0] >> 3) << 11 | (rgb[1] >> 2) << 5 | rgb[2] >> 3;
+    }
+    fclose(file);
+    return valid;
+}
+
+/**
+ * @brief Report where a rendered image differs from its reference
+ * @param name Name of the scene
+ * @param expected Reference image
+ * @param actual Rendered image
+ * @return uint32_t Number of differing pixels
+*/
+static uint32_t compare(const char* name, const uint16_t* expected, const uint16_t* actual)
+{
+    uint32_t differences = 0;
+    int32_t left = GOLDEN_WIDTH, top = GOLDEN_HEIGHT, right = -1, bottom = -1;
+    std::vector<uint16_t> diff(GOLDEN_PIXELS);
+
+    for (int32_t y = 0; y < GOLDEN_HEIGHT; y++)
+    {
+        for (int32_t x = 0; x < GOLDEN_WIDTH; x++)
+        {
+            uint32_t i = x + y * GOLDEN_WIDTH;
+            if (expected[i] == actual[i])
+            {
+                // a quarter of the brightness of the reference
+                diff[i] = (expected[i] >> 2) & 0x39e7;
+                continue;
+            }
+
+            if (differences < GOLDEN_REPORT_LIMIT)
+                printf("  %s (%d, %d): expected 0x%04x, got 0x%04x\n", name, x, y, expected[i], actual[i]);
+            differences++;
+            diff[i] = colors::red;
+            left = imin(left, x);
+            top = imin(top, y);
+            right = imax(right, x);
+            bottom = imax(bottom, y);
+        }
+    }
+
+    if (differences == 0)
+        return 0;
+
+    printf("  %s: %u pixels differ within (%d, %d) - (%d, %d)\n", name, differences, left, top, right, bottom);
+    writePPM(std::string(name) + ".actual.ppm", actual);
+    writePPM(std::string(name) + ".diff.ppm", diff.data());
+    return differences;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("usage: %s <reference directory> [--regenerate]\n", argv[0]);
+        return 1;
+    }
+    std::string directory = argv[1];
+    bool regenerate = argc > 2 && strcmp(argv[2], "--regenerate") == 0;
+
+    for (const auto& scene : scenes)
+    {
+        auto context = std::make_unique<goldenContext>();
+        scene.scene(*context);
+        std::string path = directory + "/" + scene.name + ".ppm";
+
+        if (regenerate)
+        {
+            CHECK(writePPM(path, context->frameBuffer));
+            printf("%s: written\n", scene.name);
+            continue;
+        }
+
+        uint16_t expected[GOLDEN_PIXELS];
+        if (!readPPM(path, expected))
+        {
+            printf("%s: missing reference %s, run with --regenerate\n", scene.name, path.c_str());
+            checkFailures++;
+            continue;
+        }
+
+        uint32_t differences = compare(scene.name, expected, context->frameBuffer);
+        printf("%s: %s\n", scene.name, differences == 0 ? "ok" : "FAILED");
+        CHECK(differences == 0);
+    }
+
+    return checkFailures ? 1 : 0;
+}
\ No newline at end of file
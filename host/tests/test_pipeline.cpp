@@ -0,0 +1,145 @@
+#include <memory>
+#include "check.hpp"
+#include "st7789.hpp"
+#include "pipeline.hpp"
+
+#define WIDTH 45
+#define HEIGHT 61
+#define FRAMES 40
+
+// Every frame has to reach the panel whole and in the order it was queued
+static void frameOrdering(void)
+{
+    mock::reset();
+    mock_panel panel(240, 320);
+    mock::attachSPI(spi0, TEST_DC_PIN);
+    mock::attachPanel(&panel);
+    display_config_t config = spiConfig(WIDTH, HEIGHT);
+    hardware_driver hw(&config);
+    auto disp = std::make_unique<st7789>(&hw, &config);
+    hw.init();
+    disp->init();
+    mock::recordBus(true);
+    mock::clearRecorders();
+
+    pipeline flush(disp.get());
+    flush.start();
+
+    static uint16_t buffers[2][WIDTH * HEIGHT];
+    uint32_t jobs[2] = { 0, 0 };
+    for (uint16_t frame = 1; frame <= FRAMES; frame++)
+    {
+        // the buffer must not be drawn into before its last job is done
+        int b = frame & 1;
+        flush.waitFor(jobs[b]);
+        for (uint16_t& pixel : buffers[b])
+            pixel = frame;
+        jobs[b] = flush.submitFrame(buffers[b]);
+    }
+    flush.stop();
+
+    // read the pixel stream back, a mixed frame would show up as a change mid frame
+    std::vector<uint16_t> pixels;
+    for (const mock_bus_event& event : mock::getBusEvents())
+        if (event.dc && event.bits == 16)
+            pixels.push_back(event.value);
+
+    CHECK(pixels.size() == FRAMES * WIDTH * HEIGHT);
+    bool ordered = true;
+    for (size_t i = 0; i < pixels.size(); i++)
+        ordered &= pixels[i] == i / (WIDTH * HEIGHT) + 1;
+    CHECK(ordered);
+    CHECK(flush.getCompleted() == FRAMES);
+}
+
+static void stripsAndRects(void)
+{
+    mock::reset();
+    mock_panel panel(240, 320);
+    mock::attachSPI(spi0, TEST_DC_PIN);
+    mock::attachPanel(&panel);
+    display_config_t config = spiConfig(WIDTH, HEIGHT);
+    hardware_driver hw(&config);
+    auto disp = std::make_unique<st7789>(&hw, &config);
+    hw.init();
+    disp->init();
+
+    pipeline flush(disp.get());
+    flush.start();
+
+    uint16_t strip[WIDTH * 8];
+    uint32_t job = 0;
+    for (uint32_t top = 0; top < HEIGHT; top += 8)
+    {
+        flush.waitFor(job);
+        for (uint16_t& pixel : strip)
+            pixel = 1000 + top;
+        job = flush.submitStrip(strip, top, 8);
+    }
+
+    static uint16_t frame[WIDTH * HEIGHT];
+    for (uint16_t& pixel : frame)
+        pixel = 7;
+    flush.waitFor(flush.submitRect(frame, rect(10, 10, 20, 30)));
+    flush.stop();
+
+    int mismatches = 0;
+    for (uint32_t y = 0; y < HEIGHT; y++)
+    {
+        for (uint32_t x = 0; x < WIDTH; x++)
+        {
+            bool inside = x >= 10 && x <= 20 && y >= 10 && y <= 30;
+            uint16_t expected = inside ? 7 : 1000 + (y / 8) * 8;
+            mismatches += panel.getPixel(x, y) != expected;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+// Without core 1 the jobs are sent on the calling core instead of waiting forever
+static void notRunning(void)
+{
+    mock::reset();
+    mock_panel panel(240, 320);
+    mock::attachSPI(spi0, TEST_DC_PIN);
+    mock::attachPanel(&panel);
+    display_config_t config = spiConfig(WIDTH, HEIGHT);
+    hardware_driver hw(&config);
+    auto disp = std::make_unique<st7789>(&hw, &config);
+    hw.init();
+    disp->init();
+    panel.resetCounters();
+
+    static uint16_t frame[WIDTH * HEIGHT];
+    pipeline flush(disp.get());
+    uint32_t job = 0;
+    for (uint16_t i = 1; i <= PIPELINE_QUEUE_SIZE + 2; i++)
+    {
+        for (uint16_t& pixel : frame)
+            pixel = i;
+        job = flush.submitFrame(frame);
+        CHECK(flush.isDone(job));
+    }
+    flush.waitIdle();
+    CHECK(panel.getPixelsWritten() == (PIPELINE_QUEUE_SIZE + 2) * WIDTH * HEIGHT);
+    CHECK(countMismatches(panel, frame, WIDTH, HEIGHT) == 0);
+
+    // the same once the pipeline has been stopped again
+    flush.start();
+    flush.submitFrame(frame);
+    flush.stop();
+    for (uint16_t& pixel : frame)
+        pixel = 99;
+    flush.waitFor(flush.submitRect(frame, rect(10, 10, 20, 30)));
+    CHECK(panel.getPixel(10, 10) == 99);
+    CHECK(panel.getPixel(9, 10) == PIPELINE_QUEUE_SIZE + 2);
+    CHECK(flush.getCompleted() == PIPELINE_QUEUE_SIZE + 4);
+}
+
+int main(void)
+{
+    RUN(frameOrdering);
+    RUN(stripsAndRects);
+    RUN(notRunning);
+    return checkFailures ? 1 : 0;
+}
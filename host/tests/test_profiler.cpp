@@ -0,0 +1,99 @@
+#include <memory>
+#include <string.h>
+#include "check.hpp"
+#include "st7789.hpp"
+#include "graphics.hpp"
+#include "print.hpp"
+#include "profiler.hpp"
+#include "RobotoMono16.font"
+
+#define WIDTH 160
+#define HEIGHT 120
+
+/**
+ * @brief Find a call in a recorded frame
+ * @param frame Frame to search
+ * @param name Name of the call
+ * @return const profile_entry_t* The entry, nullptr if the call was not recorded
+*/
+static const profile_entry_t* findEntry(const profile_frame_t* frame, const char* name)
+{
+    for (size_t i = 0; i < frame->count; i++)
+        if (strcmp(frame->entries[i].name, name) == 0)
+            return &frame->entries[i];
+    return nullptr;
+}
+
+int main(void)
+{
+    mock::reset();
+    mock_panel panel(240, 320);
+    mock::attachSPI(spi0, TEST_DC_PIN);
+    mock::attachPanel(&panel);
+    display_config_t config = spiConfig(WIDTH, HEIGHT);
+    hardware_driver hw(&config);
+    auto disp = std::make_unique<st7789>(&hw, &config);
+    graphics gfx(disp->getFrameBuffer(), &config);
+    printer text(disp->getFrameBuffer(), &config);
+    text.setFont(&RobotoMono16);
+    hw.init();
+    disp->init();
+    profiler::reset();
+
+    // one frame with nested calls and a full flush
+    gfx.fill(colors::black);
+    for (int i = 0; i < 3; i++)
+        gfx.drawFilledCircle({ 40 + i * 30, 60 }, 10, colors::red);
+    gfx.drawFilledCircleWithStroke({ 120, 60 }, 20, colors::blue, colors::white, 2);
+    text.print("frame");
+    disp->update();
+    disp->frameCounter();
+
+    printf("calls\n");
+    const profile_frame_t* frame = profiler::getFrame(0);
+    CHECK(profiler::getFrameCount() == 1);
+    CHECK(frame != nullptr && frame->frame == 0);
+    if (frame != nullptr)
+    {
+        const profile_entry_t* fill = findEntry(frame, "fill");
+        const profile_entry_t* circle = findEntry(frame, "drawFilledCircle");
+        const profile_entry_t* stroke = findEntry(frame, "drawFilledCircleWithStroke");
+        CHECK(fill != nullptr && fill->calls == 1 && fill->pixels == WIDTH * HEIGHT);
+        CHECK(circle != nullptr && circle->calls == 3 && circle->pixels == 3 * profileCircleArea(10));
+        CHECK(stroke != nullptr && stroke->calls == 1);
+        CHECK(findEntry(frame, "drawCircle") == nullptr);
+        CHECK(findEntry(frame, "print") != nullptr);
+        CHECK(frame->busBytes >= WIDTH * HEIGHT * 2);
+        CHECK(frame->busBytes < WIDTH * HEIGHT * 2 + 32);
+        CHECK(frame->dropped == 0);
+    }
+
+    printf("ring\n");
+    for (int i = 0; i < PROFILE_FRAMES + 3; i++)
+    {
+        gfx.drawLine({ 0, 0 }, { i, 10 }, colors::white);
+        profiler::endFrame();
+    }
+    CHECK(profiler::getFrameCount() == PROFILE_FRAMES + 4);
+    CHECK(profiler::getFrame(PROFILE_FRAMES) == nullptr);
+    for (uint32_t age = 0; age < PROFILE_FRAMES; age++)
+    {
+        frame = profiler::getFrame(age);
+        CHECK(frame != nullptr && frame->frame == PROFILE_FRAMES + 3 - age);
+        CHECK(frame != nullptr && frame->count == 1 && frame->busBytes == 0);
+    }
+
+    printf("overlay\n");
+    gfx.fill(colors::black);
+    profiler::endFrame();
+    profiler::drawOverlay(&gfx, &text, { 4, 4 }, 16);
+    profiler::endFrame();
+    CHECK(profiler::getFrame(0)->count == 0);
+    int lit = 0;
+    for (uint32_t i = 0; i < WIDTH * HEIGHT; i++)
+        lit += disp->getFrameBuffer()[i] != 0;
+    CHECK(lit > 0);
+
+    profiler::dump();
+    return checkFailures ? 1 : 0;
+}
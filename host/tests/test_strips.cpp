@@ -0,0 +1,76 @@
+#include <memory>
+#include <vector>
+#include "check.hpp"
+#include "st7789.hpp"
+#include "graphics.hpp"
+#include "damage.hpp"
+#include "scene.hpp"
+
+// Built with DISPLAY_NO_FRAMEBUFFER, the display only has the strips it is given
+#define WIDTH 45
+#define HEIGHT 61
+#define STRIP_ROWS 8
+
+/**
+ * @brief Record the same shapes into a scene
+ * @param s Scene to record into
+*/
+static void recordScene(scene& s)
+{
+    s.fill(colors::black);
+    s.drawFilledCircle({ 22, 30 }, 12, colors::yellow);
+    s.drawFilledRectangle({ 3, 4 }, { 10, 10 }, colors::green);
+    s.drawLineThickAntiAliased({ 0, 60 }, { 44, 20 }, 3, colors::cyan);
+}
+
+int main(void)
+{
+    mock::reset();
+    mock_panel panel(240, 320);
+    mock::attachSPI(spi0, TEST_DC_PIN);
+    mock::attachPanel(&panel);
+    display_config_t config = spiConfig(WIDTH, HEIGHT);
+    hardware_driver hw(&config);
+    auto disp = std::make_unique<st7789>(&hw, &config);
+    graphics gfx(disp->getFrameBuffer(), &config);
+    damageTracker damage(&config);
+    hw.init();
+    disp->init();
+    disp->attach(&gfx);
+    disp->setDamageTracker(&damage);
+    CHECK(disp->getFrameBuffer() == nullptr);
+
+    // the frame drawn at once into a buffer of our own
+    std::vector<uint16_t> expected(WIDTH * HEIGHT);
+    graphics reference(expected.data(), &config);
+    scene referenceScene(&reference);
+    recordScene(referenceScene);
+    referenceScene.render();
+
+    scene s(&gfx);
+    recordScene(s);
+    uint16_t strip[WIDTH * STRIP_ROWS];
+    disp->setStrips(strip, nullptr, STRIP_ROWS);
+    disp->render(&s);
+    disp->waitIdle();
+    CHECK(countMismatches(panel, expected.data(), WIDTH, HEIGHT) == 0);
+    CHECK(!damage.isEmpty());
+
+    // every band is on the panel already, there is no frame buffer to send from
+    panel.resetCounters();
+    disp->flushDirty();
+    CHECK(panel.getPixelsWritten() == 0);
+    CHECK(damage.isEmpty());
+
+    disp->update();
+    disp->update(rect(5, 6, 14, 20));
+    disp->update(0, WIDTH);
+    disp->update(0, WIDTH, true);
+    disp->setPixel({ 1, 1 }, colors::red);
+    disp->setPixel(0, 0xffff);
+    CHECK(disp->getPixel(0) == 0);
+    CHECK(panel.getPixelsWritten() == 0);
+    CHECK(countMismatches(panel, expected.data(), WIDTH, HEIGHT) == 0);
+
+    return checkFailures ? 1 : 0;
+}
@@ -0,0 +1,205 @@
+#include "chart.hpp"
+
+/**
+ * @brief Construct a new line chart
+ * @param graphics Graphics object to draw with
+ * @param start Upper left corner of the chart
+ * @param end Lower right corner of the chart, not part of it
+ * @param minValue Value at the bottom of the chart
+ * @param maxValue Value at the top of the chart
+ * @param samplesPerColumn Number of samples that share a column, more than one draws
+ * the lowest to the highest sample of every column
+ * @note The newest column is on the right and older ones scroll out to the left
+*/
+lineChart::lineChart(graphics* graphics, point start, point end, int32_t minValue, int32_t maxValue, uint32_t samplesPerColumn)
+{
+    this->graphics_ptr = graphics;
+    this->start = start;
+    this->end = end;
+    this->minValue = minValue;
+    this->maxValue = maxValue;
+    this->samplesPerColumn = imax(1, imin(samplesPerColumn, CHART_MAX_SAMPLES));
+}
+
+/**
+ * @brief Throw away every sample, the next update redraws the whole chart
+*/
+void lineChart::clear(void)
+{
+    this->head = 0;
+    this->count = 0;
+    this->pending = 0;
+    this->newColumns = 0;
+    this->drawn = false;
+}
+
+/**
+ * @brief Add a sample to the chart
+ * @param sample Sample to add
+ * @note Nothing is drawn until update() or draw() is called
+*/
+void lineChart::push(int32_t sample)
+{
+    this->samples[this->head] = sample;
+    this->head = (this->head + 1) % CHART_MAX_SAMPLES;
+    if (this->count < CHART_MAX_SAMPLES)
+        this->count++;
+
+    // a column is on the screen once all of its samples are in
+    if (++this->pending < this->samplesPerColumn)
+        return;
+    this->pending = 0;
+    if (this->newColumns < (uint32_t)(this->end.x - this->start.x))
+        this->newColumns++;
+}
+
+/**
+ * @brief Add samples to the chart
+ * @param samples Samples to add, oldest first
+ * @param numberOfSamples Number of samples
+*/
+void lineChart::push(const int32_t* samples, size_t numberOfSamples)
+{
+    for (size_t i = 0; i < numberOfSamples; i++)
+        this->push(samples[i]);
+}
+
+/**
+ * @brief Redraw the whole chart from the samples it keeps
+*/
+void lineChart::draw(void)
+{
+    PROFILE_SCOPE("lineChart::draw", (this->end.x - this->start.x) * (this->end.y - this->start.y));
+
+    bool clipped = this->graphics_ptr->pushClip(this->start, this->end);
+    this->graphics_ptr->drawFilledRectangle(this->start, this->end, this->background);
+
+    uint32_t columns = imin((this->count - this->pending) / this->samplesPerColumn, this->end.x - this->start.x);
+    for (uint32_t age = columns; age-- > 0;)
+        this->drawColumn(age);
+
+    if (clipped)
+        this->graphics_ptr->popClip();
+    this->newColumns = 0;
+    this->drawn = true;
+}
+
+/**
+ * @brief Bring the chart up to date with the samples pushed since the last update
+ * @note The chart is moved to the left and only the new columns are drawn,
+ * the first update and one after a whole chart of new columns redraw everything
+*/
+void lineChart::update(void)
+{
+    if (!this->drawn || this->newColumns >= (uint32_t)(this->end.x - this->start.x))
+    {
+        this->draw();
+        return;
+    }
+    if (this->newColumns == 0)
+        return;
+
+    PROFILE_SCOPE("lineChart::update", this->newColumns * (this->end.y - this->start.y));
+
+    bool clipped = this->graphics_ptr->pushClip(this->start, this->end);
+    int32_t shift = this->newColumns;
+    this->graphics_ptr->scroll(this->start, this->end, -shift, 0);
+    this->graphics_ptr->drawFilledRectangle(point(this->end.x - shift, this->start.y), this->end, this->background);
+
+    for (uint32_t age = this->newColumns; age-- > 0;)
+        this->drawColumn(age);
+
+    if (clipped)
+        this->graphics_ptr->popClip();
+    this->newColumns = 0;
+}
+
+/**
+ * @brief Get a sample from the ring buffer
+ * @param age 0 for the newest sample, 1 for the one before and so on
+ * @return int32_t The sample
+ * @private
+*/
+int32_t lineChart::getSample(size_t age)
+{
+    return this->samples[(this->head + CHART_MAX_SAMPLES - 1 - age) % CHART_MAX_SAMPLES];
+}
+
+/**
+ * @brief Gather the samples of a finished column
+ * @param age 0 for the newest finished column, 1 for the one before and so on
+ * @param column Filled with the samples of the column
+ * @return bool False if the samples of the column are no longer kept
+ * @private
+*/
+bool lineChart::getColumn(uint32_t age, chart_column_t* column)
+{
+    size_t newest = this->pending + age * this->samplesPerColumn;
+    size_t oldest = newest + this->samplesPerColumn - 1;
+    if (oldest >= this->count)
+        return false;
+
+    column->first = this->getSample(oldest);
+    column->low = column->first;
+    column->high = column->first;
+    for (size_t i = newest; i < oldest; i++)
+    {
+        int32_t sample = this->getSample(i);
+        column->low = imin(column->low, sample);
+        column->high = imax(column->high, sample);
+    }
+    return true;
+}
+
+/**
+ * @brief Get the row a value is drawn at
+ * @param value Value to get the row of, limited to the range of the chart
+ * @return int32_t The row
+ * @private
+*/
+int32_t lineChart::getRow(int32_t value)
+{
+    int32_t range = this->maxValue - this->minValue;
+    if (range <= 0)
+        return this->end.y - 1;
+
+    int64_t offset = imax(0, imin(value, this->maxValue) - this->minValue);
+    return this->end.y - 1 - (int32_t)((offset * (this->end.y - this->start.y - 1) + range / 2) / range);
+}
+
+/**
+ * @brief Draw a finished column and join it to the column before
+ * @param age 0 for the newest finished column, 1 for the one before and so on
+ * @private
+*/
+void lineChart::drawColumn(uint32_t age)
+{
+    chart_column_t column;
+    if (!this->getColumn(age, &column))
+        return;
+
+    int32_t x = this->end.x - 1 - age;
+    int32_t top = this->getRow(column.high);
+    int32_t bottom = this->getRow(column.low);
+
+    // the newest sample of the column before, it can be gone from the ring buffer already
+    size_t previousAge = this->pending + (age + 1) * this->samplesPerColumn;
+    bool joined = previousAge < this->count;
+    int32_t previous = joined ? this->getRow(this->getSample(previousAge)) : top;
+
+    if (this->antiAliased)
+    {
+        if (joined)
+            this->graphics_ptr->drawLineAntiAliased(point(x - 1, previous), point(x, this->getRow(column.first)), this->traceColor);
+    }
+    else
+    {
+        // stretch the column up to the row next to the one before so the trace has no gaps
+        if (previous < top)
+            top = previous + 1;
+        else if (previous > bottom)
+            bottom = previous - 1;
+    }
+
+    this->graphics_ptr->drawLine(point(x, top), point(x, bottom), this->traceColor);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "graphics.hpp"
+
+// Number of samples a chart keeps, a full redraw shows at most this many
+// divided by the samples per column
+#ifndef CHART_MAX_SAMPLES
+#define CHART_MAX_SAMPLES 1024
+#endif
+
+// The samples that fall into one column of the chart
+typedef struct
+{
+    int32_t first;      // oldest sample of the column
+    int32_t low;        // lowest sample of the column
+    int32_t high;       // highest sample of the column
+} chart_column_t;
+
+class lineChart
+{
+public:
+    lineChart(graphics* graphics, point start, point end, int32_t minValue, int32_t maxValue, uint32_t samplesPerColumn = 1);
+
+    void setColor(color value) { this->traceColor = value; }
+    void setBackgroundColor(color value) { this->background = value; }
+    void setAntiAliasing(bool value) { this->antiAliased = value; }
+
+    void clear(void);
+    void push(int32_t sample);
+    void push(const int32_t* samples, size_t numberOfSamples);
+
+    void draw(void);
+    void update(void);
+
+private:
+    graphics* graphics_ptr = nullptr;
+    point start = { 0, 0 };
+    point end = { 0, 0 };
+    int32_t minValue = 0;
+    int32_t maxValue = 0;
+    uint32_t samplesPerColumn = 1;
+    color traceColor = colors::white;
+    color background = colors::black;
+    bool antiAliased = false;
+
+    // ring buffer of the newest samples, head is where the next one goes
+    int32_t samples[CHART_MAX_SAMPLES];
+    size_t head = 0;
+    size_t count = 0;
+    // samples of the column that is not finished yet
+    uint32_t pending = 0;
+    // finished columns that are not on the screen yet
+    uint32_t newColumns = 0;
+    bool drawn = false;
+
+    int32_t getSample(size_t age);
+    bool getColumn(uint32_t age, chart_column_t* column);
+    int32_t getRow(int32_t value);
+    void drawColumn(uint32_t age);
+};
\ No newline at end of file
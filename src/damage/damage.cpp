@@ -0,0 +1,137 @@
+#include "damage.hpp"
+
+/**
+ * @brief Construct a new damage tracker
+ * @param config Display parameters, used to clamp the rects to the screen
+*/
+damageTracker::damageTracker(display_config_t* config)
+{
+    this->config = config;
+}
+
+/**
+ * @brief Mark an area of the framebuffer as changed
+ * @param x0 Left edge
+ * @param y0 Top edge
+ * @param x1 Right edge, included in the area
+ * @param y1 Bottom edge, included in the area
+ * @note Rects that overlap or touch are merged into one
+*/
+void damageTracker::add(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    if (this->fullScreen)
+        return;
+
+    // clamp the area to the screen
+    x0 = imax(x0, 0);
+    y0 = imax(y0, 0);
+    x1 = imin(x1, (int32_t)this->config->width - 1);
+    y1 = imin(y1, (int32_t)this->config->height - 1);
+    if (x1 < x0 || y1 < y0)
+        return;
+
+    // grow the area by every rect it touches, the grown area may touch rects it missed before
+    for (size_t i = 0; i < this->count;)
+    {
+        bool touches = x0 <= this->x1[i] + 1 && this->x0[i] <= x1 + 1 &&
+            y0 <= this->y1[i] + 1 && this->y0[i] <= y1 + 1;
+
+        if (!touches)
+        {
+            i++;
+            continue;
+        }
+
+        x0 = imin(x0, this->x0[i]);
+        y0 = imin(y0, this->y0[i]);
+        x1 = imax(x1, this->x1[i]);
+        y1 = imax(y1, this->y1[i]);
+        this->remove(i);
+        i = 0;
+    }
+
+    // out of rects, a single full frame is the cheapest way out
+    if (this->count >= DAMAGE_MAX_RECTS)
+    {
+        this->addAll();
+        return;
+    }
+
+    this->x0[this->count] = x0;
+    this->y0[this->count] = y0;
+    this->x1[this->count] = x1;
+    this->y1[this->count] = y1;
+    this->count++;
+
+    // past a certain point the extra window commands cost more than they save
+    uint32_t totalPixels = this->config->width * this->config->height;
+    if (this->getArea() * 100 >= totalPixels * DAMAGE_FULL_SCREEN_PERCENT)
+        this->addAll();
+}
+
+/**
+ * @brief Mark an area of the framebuffer as changed
+ * @param area Area to mark, the edges are included
+*/
+void damageTracker::add(rect area)
+{
+    this->add(area.left(), area.top(), area.right(), area.bottom());
+}
+
+/**
+ * @brief Mark the entire framebuffer as changed
+*/
+void damageTracker::addAll(void)
+{
+    this->fullScreen = true;
+    this->count = 0;
+}
+
+/**
+ * @brief Forget all damage, call after the changes are sent to the display
+*/
+void damageTracker::clear(void)
+{
+    this->fullScreen = false;
+    this->count = 0;
+}
+
+/**
+ * @brief Get a damaged rect
+ * @param index Index of the rect, below getCount()
+ * @return rect The damaged area, the edges are included
+*/
+rect damageTracker::getRect(size_t index)
+{
+    if (index >= this->count)
+        return rect();
+
+    return rect(this->x0[index], this->y0[index], this->x1[index], this->y1[index]);
+}
+
+/**
+ * @private
+ * @brief Remove a rect from the list
+ * @param index Index of the rect
+*/
+void damageTracker::remove(size_t index)
+{
+    this->count--;
+    this->x0[index] = this->x0[this->count];
+    this->y0[index] = this->y0[this->count];
+    this->x1[index] = this->x1[this->count];
+    this->y1[index] = this->y1[this->count];
+}
+
+/**
+ * @private
+ * @brief Get the number of damaged pixels
+ * @return uint32_t Sum of the area of all rects, they never overlap
+*/
+uint32_t damageTracker::getArea(void)
+{
+    uint32_t area = 0;
+    for (size_t i = 0; i < this->count; i++)
+        area += (this->x1[i] - this->x0[i] + 1) * (this->y1[i] - this->y0[i] + 1);
+    return area;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "display_struct.h"
+#include "shapes.hpp"
+#include "gfxmath.h"
+
+// Number of separate rects that are tracked, more than this flushes the whole screen
+#ifndef DAMAGE_MAX_RECTS
+#define DAMAGE_MAX_RECTS 8
+#endif
+
+// Damage covering more than this share of the screen flushes the whole screen
+#ifndef DAMAGE_FULL_SCREEN_PERCENT
+#define DAMAGE_FULL_SCREEN_PERCENT 75
+#endif
+
+class damageTracker
+{
+public:
+    damageTracker(display_config_t* config);
+
+    void add(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+    void add(rect area);
+    void addAll(void);
+    void clear(void);
+
+    bool isEmpty(void) { return this->count == 0 && !this->fullScreen; }
+    bool isFullScreen(void) { return this->fullScreen; }
+    size_t getCount(void) { return this->count; }
+    rect getRect(size_t index);
+
+private:
+    display_config_t* config;
+
+    // Inclusive bounds of every damaged rect
+    int32_t x0[DAMAGE_MAX_RECTS];
+    int32_t y0[DAMAGE_MAX_RECTS];
+    int32_t x1[DAMAGE_MAX_RECTS];
+    int32_t y1[DAMAGE_MAX_RECTS];
+    size_t count = 0;
+    bool fullScreen = false;
+
+    void remove(size_t index);
+    uint32_t getArea(void);
+};
\ No newline at end of file
@@ -1,13 +1,18 @@
 #include "display.hpp"
+#include "graphics.hpp"
+#include "print.hpp"
+#include "gradient.hpp"
+#include "scene.hpp"
 
 /**
  * @brief display initialization
 */
-display::display(hardware_driver* hw, display_config_t* config, uint16_t* frameBuffer, uint8_t CASET, uint8_t RASET, uint8_t RAMWR)
+display::display(hardware_driver* hw, display_config_t* config, uint16_t* frameBuffer, uint8_t CASET, uint8_t RASET, uint8_t RAMWR, uint32_t* tileHashes)
 {
     this->hw = hw;
     this->config = config;
     this->frameBuffer = frameBuffer;
+    this->tileHashes = tileHashes;
     this->CASET = CASET;
     this->RASET = RASET;
     this->RAMWR = RAMWR;
@@ -56,24 +61,57 @@ display::display(hardware_driver* hw, display_config_t* config, uint16_t* frameB
 
 /**
  * @brief Clear the display by drawing a black rectangle
+ * @note Without a frame buffer a cleared strip is sent over the whole display
 */
 void display::clear()
 {
+    if (this->frameBuffer == nullptr)
+    {
+        if (this->strips[0] == nullptr)
+            return;
+
+        // the strip might still be on the wire
+        this->hw->waitIdle();
+        uint32_t width = this->config->width;
+        uint32_t height = this->config->height;
+        fillSpan(this->strips[0], 0x0000, width * this->stripRows);
+
+        this->setCursor({ 0, 0 });
+        for (uint32_t top = 0; top < height; top += this->stripRows)
+            this->writePixels(this->strips[0], width * imin(this->stripRows, height - top));
+        return;
+    }
+
     // set the cursor position to the top left
     this->setCursor({ 0, 0 });
     // fill the frame buffer
-    uint32_t totalPixels = this->config->width * this->config->height;
-    for (int32_t i = 0; i < totalPixels; i++)
-        this->frameBuffer[i] = 0x0000;
+    fillSpan(this->frameBuffer, 0x0000, this->config->width * this->config->height);
     this->setCursor({ 0, 0 });
     this->update();
 }
 
 /**
  * @brief Print the frame buffer to the display
+ * @note In double buffer mode this only starts the transfer, see present()
+ * @note In frame diff mode only the tiles that changed since the last update are sent
  */
 void display::update()
 {
+    if (this->frameBuffer == nullptr)
+        return;
+
+    if (this->frameDiff)
+    {
+        this->updateDiff();
+        return;
+    }
+
+    if (this->backBuffer != nullptr)
+    {
+        this->present();
+        return;
+    }
+
     this->setCursor({ 0, 0 });
     uint32_t totalPixels = this->config->width * this->config->height;
     this->writePixels(this->frameBuffer, totalPixels);
@@ -87,6 +125,9 @@ void display::update()
 */
 void display::update(int32_t start, int32_t end)
 {
+    if (this->frameBuffer == nullptr)
+        return;
+
     this->writePixels(&this->frameBuffer[start], end - start);
 }
 
@@ -98,6 +139,9 @@ void display::update(int32_t start, int32_t end)
 */
 void display::update(int32_t start, int32_t end, bool moveCursor)
 {
+    if (this->frameBuffer == nullptr)
+        return;
+
     uint32_t totalPixels = this->config->width * this->config->height;
 
     // Check if the start and end are valid
@@ -138,27 +182,269 @@ void display::update(point start, point end)
 
 /**
  * @brief Partially update the display with a section of the frame buffer
- * @param rect Rectangle to update
+ * @param rect Rectangle to update, the edges are included
+ * @note The window is set once and all rows are sent in a single transfer
 */
 void display::update(rect r)
 {
-    // Check if the start and end are valid
-    if (r.left() < 0 || r.top() < 0)
+    if (this->frameBuffer == nullptr)
         return;
-        
+
     // clamp the box to the display
     point min = point(0, 0);
     point max = point(this->config->width - 1, this->config->height - 1);
     r = r.clamp(min, max);
-        
-    for (int32_t y = r.top(); y <= r.bottom(); y++)
+
+    // Check if anything is left
+    if (r.right() < r.left() || r.bottom() < r.top())
+        return;
+
+    this->setWindow({r.left(), r.top()}, {r.right(), r.bottom()});
+
+    uint32_t width = r.right() - r.left() + 1;
+    uint32_t height = r.bottom() - r.top() + 1;
+    this->writePixelsStrided(&this->frameBuffer[r.left() + r.top() * this->config->width], 
+        width, height, this->config->width);
+}
+
+/**
+ * @brief Send only the parts of the frame buffer that the damage tracker has seen change
+ * @note Without a tracker this is a full update, the tracker is cleared afterwards
+ * @note Always sends from the buffer being drawn, it does not swap in double buffer mode
+ * @note Without a frame buffer render() has sent every band already, so the damage is only cleared
+*/
+void display::flushDirty(void)
+{
+    if (this->frameBuffer == nullptr)
+    {
+        if (this->damage != nullptr)
+            this->damage->clear();
+        return;
+    }
+
+    if (this->damage == nullptr)
+    {
+        this->update();
+        return;
+    }
+
+    if (this->damage->isFullScreen())
+    {
+        this->setCursor({ 0, 0 });
+        uint32_t totalPixels = this->config->width * this->config->height;
+        this->writePixels(this->frameBuffer, totalPixels);
+    }
+    else
+    {
+        for (size_t i = 0; i < this->damage->getCount(); i++)
+            this->update(this->damage->getRect(i));
+    }
+
+    this->damage->clear();
+}
+
+/**
+ * @brief Only send the parts of the frame that changed on update()
+ * @param enabled True to compare every frame against the last one that was sent
+ * @note Changes are found with a hash per tile, so there is a tiny chance a change is missed
+ * @note Frame diff updates are blocking and do not swap buffers in double buffer mode
+*/
+void display::setFrameDiff(bool enabled)
+{
+    this->frameDiff = enabled && this->tileHashes != nullptr && this->frameBuffer != nullptr;
+    this->tileHashesValid = false;
+}
+
+/**
+ * @brief Set the strip buffers used by render()
+ * @param strip Buffer of width * rows pixels
+ * @param secondStrip Optional second buffer of the same size, drawn into while the other is sent
+ * @param rows Number of display rows each strip holds
+*/
+void display::setStrips(uint16_t* strip, uint16_t* secondStrip, uint32_t rows)
+{
+    // the old strips might still be on the wire
+    this->hw->waitIdle();
+    this->strips[0] = strip;
+    this->strips[1] = secondStrip;
+    this->stripRows = rows;
+}
+
+/**
+ * @brief Draw a scene band by band and send each band as soon as it is done
+ * @param scene Scene to replay for every band
+ * @note With two strips the next band is drawn while the previous one is sent
+ * @note Returns while the last band is still being sent, the objects of the scene are pointed back at the frame buffer
+*/
+void display::render(scene* scene)
+{
+    if (this->strips[0] == nullptr || this->stripRows == 0)
+        return;
+
+    uint32_t width = this->config->width;
+    uint32_t height = this->config->height;
+    size_t current = 0;
+
+    // the bands follow each other, so one window covers all of them
+    this->hw->waitIdle();
+    this->setCursor({ 0, 0 });
+
+    for (uint32_t top = 0; top < height; top += this->stripRows)
+    {
+        uint32_t rows = imin(this->stripRows, height - top);
+        uint16_t* strip = this->strips[current];
+
+        // with a single strip the previous band has to leave it first
+        if (this->strips[1] == nullptr)
+            this->hw->waitIdle();
+
+        scene->renderBand(strip, top, rows);
+
+        this->hw->waitIdle();
+        this->writePixelsAsync(strip, width * rows);
+
+        if (this->strips[1] != nullptr)
+            current ^= 1;
+    }
+
+    scene->setFrameBuffer(this->frameBuffer);
+}
+
+/**
+ * @brief Set the damage tracker used by flushDirty()
+ * @param tracker Tracker the attached drawing objects report into, nullptr to disable
+*/
+void display::setDamageTracker(damageTracker* tracker)
+{
+    this->damage = tracker;
+
+    for (size_t i = 0; i < DISPLAY_MAX_CLIENTS; i++)
+    {
+        if (this->graphicsClients[i] != nullptr)
+            this->graphicsClients[i]->setDamageTracker(tracker);
+        if (this->printerClients[i] != nullptr)
+            this->printerClients[i]->setDamageTracker(tracker);
+        if (this->gradientClients[i] != nullptr)
+            this->gradientClients[i]->setDamageTracker(tracker);
+    }
+}
+
+/**
+ * @brief Enable double buffering by supplying a second framebuffer
+ * @param backBuffer Buffer of width * height pixels, nullptr to go back to a single buffer
+ * @note The buffer is not copied, the next frame is drawn into whatever it holds
+*/
+void display::setBackBuffer(uint16_t* backBuffer)
+{
+    // the back buffer might be the one on the wire
+    this->hw->waitIdle();
+    this->backBuffer = backBuffer;
+}
+
+/**
+ * @brief Keep a graphics object pointed at the buffer being drawn
+ * @param client Graphics object to rebind on every swap
+ * @note The object also reports into the damage tracker of the display
+*/
+void display::attach(graphics* client)
+{
+    for (size_t i = 0; i < DISPLAY_MAX_CLIENTS; i++)
+    {
+        if (this->graphicsClients[i] == nullptr || this->graphicsClients[i] == client)
+        {
+            this->graphicsClients[i] = client;
+            client->setFrameBuffer(this->frameBuffer);
+            client->setDamageTracker(this->damage);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Keep a printer object pointed at the buffer being drawn
+ * @param client Printer object to rebind on every swap
+*/
+void display::attach(printer* client)
+{
+    for (size_t i = 0; i < DISPLAY_MAX_CLIENTS; i++)
+    {
+        if (this->printerClients[i] == nullptr || this->printerClients[i] == client)
+        {
+            this->printerClients[i] = client;
+            client->setFrameBuffer(this->frameBuffer);
+            client->setDamageTracker(this->damage);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Keep a gradient object pointed at the buffer being drawn
+ * @param client Gradient object to rebind on every swap
+*/
+void display::attach(gradient* client)
+{
+    for (size_t i = 0; i < DISPLAY_MAX_CLIENTS; i++)
+    {
+        if (this->gradientClients[i] == nullptr || this->gradientClients[i] == client)
+        {
+            this->gradientClients[i] = client;
+            client->setFrameBuffer(this->frameBuffer);
+            client->setDamageTracker(this->damage);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Start sending the finished frame and hand out the other buffer
+ * @note Returns as soon as the transfer is started, waiting only for the frame before it
+*/
+void display::present(void)
+{
+    if (this->backBuffer == nullptr)
+    {
+        this->update();
+        return;
+    }
+
+    // fence, the previous frame has to leave the buffer we are about to draw into
+    this->hw->waitIdle();
+
+    this->setCursor({ 0, 0 });
+    uint32_t totalPixels = this->config->width * this->config->height;
+    this->writePixelsAsync(this->frameBuffer, totalPixels);
+
+    this->swap();
+}
+
+/**
+ * @brief Exchange the front and back buffer and rebind the attached objects
+ * @note Does not send anything to the display
+*/
+void display::swap(void)
+{
+    if (this->backBuffer == nullptr)
+        return;
+
+    uint16_t* buffer = this->frameBuffer;
+    this->frameBuffer = this->backBuffer;
+    this->backBuffer = buffer;
+
+    for (size_t i = 0; i < DISPLAY_MAX_CLIENTS; i++)
     {
-        this->update({r.left(), y}, {r.right(), y});
+        if (this->graphicsClients[i] != nullptr)
+            this->graphicsClients[i]->setFrameBuffer(this->frameBuffer);
+        if (this->printerClients[i] != nullptr)
+            this->printerClients[i]->setFrameBuffer(this->frameBuffer);
+        if (this->gradientClients[i] != nullptr)
+            this->gradientClients[i]->setFrameBuffer(this->frameBuffer);
     }
 }
 
 /**
  * @brief Run after each frame to calculate the framerate
+ * @note Also closes the frame of the profiler when PICOGFX_PROFILE is defined
 */
 void display::frameCounter()
 {
@@ -169,6 +455,8 @@ void display::frameCounter()
         this->frames = this->framecounter;
         this->framecounter = 0;
     }
+
+    PROFILE_FRAME();
 }
 
 /**
@@ -197,6 +485,9 @@ bool display::frameLimiter(uint32_t frameRate)
 */
 void display::setPixel(point point, color color)
 {
+    if (this->frameBuffer == nullptr)
+        return;
+
     // set the framebuffer pixel
     this->frameBuffer[point.x + point.y * this->config->width] = color.to16bit(this->config->inverseColors);
 }
@@ -208,6 +499,9 @@ void display::setPixel(point point, color color)
 */
 void display::setPixel(uint32_t index, uint16_t color)
 {
+    if (this->frameBuffer == nullptr)
+        return;
+
     // set the framebuffer pixel
     this->frameBuffer[index] = color;
 }
@@ -215,20 +509,26 @@ void display::setPixel(uint32_t index, uint16_t color)
 /**
  * @brief Get a pixel from the framebuffer
  * @param point point to get the pixel from
- * @return Color The color of the pixel
+ * @return Color The color of the pixel, black without a frame buffer
 */
 color display::getPixel(point point)
 {
+    if (this->frameBuffer == nullptr)
+        return colors::black;
+
     return color(this->frameBuffer[point.x + point.y * this->config->width]);
 }
 
 /**
  * @brief Get a pixel from the framebuffer
  * @param point Buffer index
- * @return Color The color of the pixel
+ * @return Color The color of the pixel, 0 without a frame buffer
 */
 uint16_t display::getPixel(uint32_t index)
 {
+    if (this->frameBuffer == nullptr)
+        return 0;
+
     return this->frameBuffer[index];
 }
 
@@ -238,20 +538,34 @@ uint16_t display::getPixel(uint32_t index)
 */
 void display::setCursor(point point)
 {
-    // set the pixel x address
-    this->columnAddressSet(
+    // set the pixel address
+    this->addressWindowSet(
         point.x + this->config->columnOffset1,
-        (this->config->width - 1) + this->config->columnOffset2
-    );
-    // set the pixel y address
-    this->rowAddressSet(
         point.y + this->config->rowOffset1,
+        (this->config->width - 1) + this->config->columnOffset2,
         (this->config->height - 1) + this->config->rowOffset2
     );
     // set the internal cursor position
     this->cursor = point;
 }
 
+/**
+ * @brief Limit the pixel writes to a window
+ * @param start Upper left corner of the window
+ * @param end Lower right corner of the window, included in the window
+ * @note The next full update or setCursor() restores the full screen window
+*/
+void display::setWindow(point start, point end)
+{
+    this->addressWindowSet(
+        start.x + this->config->columnOffset1,
+        start.y + this->config->rowOffset1,
+        end.x + this->config->columnOffset1,
+        end.y + this->config->rowOffset1
+    );
+    this->cursor = start;
+}
+
 /**
  * @brief Get the cursor position
  * @return point The cursor position
@@ -316,50 +630,59 @@ void display::writeData(uint8_t command, const uint8_t* data, size_t length)
 
 /**
  * @private
- * @brief Set the column address
- * @param x0 Start column
- * @param x1 End column
+ * @brief Send a table of commands in one batch
+ * @param commands Command table, see CMD_DELAY
+ * @param length Length of the table in bytes
 */
-inline void display::columnAddressSet(uint32_t x0, uint32_t x1)
+void display::writeCommands(const uint8_t* commands, size_t length)
 {
-    // deny out of bounds
-    if (x0 >= x1 || x1 >= this->maxWidth)
-        return;
-
-    // pack the data
-    uint8_t data[4] = {
-        (uint8_t)(x0 >> 8),
-        (uint8_t)(x0 & 0xff),
-        (uint8_t)(x1 >> 8),
-        (uint8_t)(x1 & 0xff)
-    };
-
-    // write the data
-    this->writeData(this->CASET, data, sizeof(data));
+    // set the data mode
+    this->dataMode = false;
+    // write the commands
+    this->hw->writeCommands(commands, length);
 }
 
 /**
  * @private
- * @brief Set the row address
+ * @brief Set the column and row address and start the memory write
+ * @param x0 Start column
  * @param y0 Start row
+ * @param x1 End column
  * @param y1 End row
+ * @note CASET, RASET and RAMWR go out as one batch, an out of bounds axis is left as it was
 */
-inline void display::rowAddressSet(uint32_t y0, uint32_t y1)
+inline void display::addressWindowSet(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1)
 {
+    uint8_t commands[15];
+    size_t length = 0;
+
     // deny out of bounds
-    if (y0 >= y1 || y1 >= this->maxHeight)
-        return;
+    if (x0 <= x1 && x1 < this->maxWidth)
+    {
+        commands[length++] = this->CASET;
+        commands[length++] = 4;
+        commands[length++] = (uint8_t)(x0 >> 8);
+        commands[length++] = (uint8_t)(x0 & 0xff);
+        commands[length++] = (uint8_t)(x1 >> 8);
+        commands[length++] = (uint8_t)(x1 & 0xff);
+    }
 
-    // pack the data
-    uint8_t data[4] = {
-        (uint8_t)(y0 >> 8),
-        (uint8_t)(y0 & 0xff),
-        (uint8_t)(y1 >> 8),
-        (uint8_t)(y1 & 0xff)
-    };
+    if (y0 <= y1 && y1 < this->maxHeight)
+    {
+        commands[length++] = this->RASET;
+        commands[length++] = 4;
+        commands[length++] = (uint8_t)(y0 >> 8);
+        commands[length++] = (uint8_t)(y0 & 0xff);
+        commands[length++] = (uint8_t)(y1 >> 8);
+        commands[length++] = (uint8_t)(y1 & 0xff);
+    }
 
-    // write the data
-    this->writeData(this->RASET, data, sizeof(data));
+    // the pixels that follow go straight to memory
+    commands[length++] = this->RAMWR;
+    commands[length++] = 0;
+
+    this->writeCommands(commands, length);
+    this->dataMode = true;
 }
 
 /**
@@ -381,3 +704,133 @@ void display::writePixels(const uint16_t* data, size_t length)
     // write the pixels
     this->hw->writePixels(data, length);
 }
+
+
+/**
+ * @private
+ * @brief Start writing pixels to the display without waiting for them
+ * @param data data to write
+ * @param length Length of the data
+ * @note The buffer must stay untouched until the transfer is done
+*/
+void display::writePixelsAsync(const uint16_t* data, size_t length)
+{
+    if (!this->dataMode)
+    {
+        this->hw->setDataMode(this->RAMWR);
+        this->dataMode = true;
+    }
+    this->hw->writePixelsAsync(data, length);
+}
+
+/**
+ * @private
+ * @brief Write a block of pixels out of the frame buffer to the display
+ * @param data First pixel of the block
+ * @param width Number of pixels per row
+ * @param height Number of rows
+ * @param stride Number of pixels between the start of two rows
+*/
+void display::writePixelsStrided(const uint16_t* data, size_t width, size_t height, size_t stride)
+{
+    if (!this->dataMode)
+    {
+        this->hw->setDataMode(this->RAMWR);
+        this->dataMode = true;
+    }
+    this->hw->writePixelsStrided(data, width, height, stride);
+}
+
+/**
+ * @private
+ * @brief Send the tiles that changed since the last update
+ * @note Runs of changed tiles in a tile row are sent as one window
+*/
+void display::updateDiff(void)
+{
+    uint32_t width = this->config->width;
+    uint32_t height = this->config->height;
+    uint32_t tilesX = (width + DIFF_TILE_SIZE - 1) / DIFF_TILE_SIZE;
+    uint32_t tilesY = (height + DIFF_TILE_SIZE - 1) / DIFF_TILE_SIZE;
+
+    // nothing to compare against, hash everything and send the full frame
+    if (!this->tileHashesValid || width != this->diffWidth || height != this->diffHeight)
+    {
+        for (uint32_t ty = 0; ty < tilesY; ty++)
+            for (uint32_t tx = 0; tx < tilesX; tx++)
+                this->tileHashes[tx + ty * tilesX] = this->hashTile(tx, ty);
+
+        this->setCursor({ 0, 0 });
+        this->writePixels(this->frameBuffer, width * height);
+
+        this->tileHashesValid = true;
+        this->diffWidth = width;
+        this->diffHeight = height;
+        return;
+    }
+
+    for (uint32_t ty = 0; ty < tilesY; ty++)
+    {
+        int32_t runStart = -1;
+
+        // one step past the last tile to close a run that reaches the edge
+        for (uint32_t tx = 0; tx <= tilesX; tx++)
+        {
+            bool changed = false;
+            if (tx < tilesX)
+            {
+                uint32_t hash = this->hashTile(tx, ty);
+                uint32_t* stored = &this->tileHashes[tx + ty * tilesX];
+                changed = hash != *stored;
+                *stored = hash;
+            }
+
+            if (changed && runStart < 0)
+            {
+                runStart = tx;
+            }
+            else if (!changed && runStart >= 0)
+            {
+                this->update(rect(
+                    runStart * DIFF_TILE_SIZE, 
+                    ty * DIFF_TILE_SIZE, 
+                    imin(tx * DIFF_TILE_SIZE, width) - 1, 
+                    imin((ty + 1) * DIFF_TILE_SIZE, height) - 1
+                ));
+                runStart = -1;
+            }
+        }
+    }
+}
+
+/**
+ * @private
+ * @brief Hash one tile of the frame buffer
+ * @param tileX Column of the tile
+ * @param tileY Row of the tile
+ * @return uint32_t FNV-1a style hash, taken two pixels at a time
+*/
+uint32_t display::hashTile(uint32_t tileX, uint32_t tileY)
+{
+    uint32_t width = this->config->width;
+    uint32_t x0 = tileX * DIFF_TILE_SIZE;
+    uint32_t y0 = tileY * DIFF_TILE_SIZE;
+    uint32_t tileWidth = imin(DIFF_TILE_SIZE, width - x0);
+    uint32_t tileHeight = imin(DIFF_TILE_SIZE, this->config->height - y0);
+    uint32_t hash = 2166136261u;
+
+    for (uint32_t y = 0; y < tileHeight; y++)
+    {
+        const uint16_t* row = &this->frameBuffer[x0 + (y0 + y) * width];
+        uint32_t pixels = tileWidth;
+
+        // two half word loads, rows of odd width displays are not word aligned
+        for (; pixels >= 2; pixels -= 2, row += 2)
+            hash = (hash ^ (row[0] | (uint32_t)row[1] << 16)) * 16777619u;
+
+        if (pixels)
+            hash = (hash ^ *row) * 16777619u;
+    }
+
+    return hash;
+}
\ No newline at end of file
@@ -11,12 +11,30 @@
 #include "shapes.hpp"
 #include "color.h"
 #include "gfxmath.h"
+#include "span.h"
+#include "damage.hpp"
+#include "profiler.hpp"
 
+// Number of drawing objects that follow the framebuffer when it is swapped
+#define DISPLAY_MAX_CLIENTS 4
+
+// Size of the square tiles compared by the frame diff mode, in pixels
+#define DIFF_TILE_SIZE 16
+#define DIFF_TILE_COUNT(width, height) ((((width) + DIFF_TILE_SIZE - 1) / DIFF_TILE_SIZE) * (((height) + DIFF_TILE_SIZE - 1) / DIFF_TILE_SIZE))
+
+class graphics;
+class printer;
+class gradient;
+class scene;
+class pipeline;
 
 class display
 {
+    // flushes from core 1 with the protected writers
+    friend class pipeline;
+
 public:
-    display(hardware_driver* hw, display_config_t* config, uint16_t* frameBuffer, uint8_t CASET, uint8_t RASET, uint8_t RAMWR);
+    display(hardware_driver* hw, display_config_t* config, uint16_t* frameBuffer, uint8_t CASET, uint8_t RASET, uint8_t RAMWR, uint32_t* tileHashes = nullptr);
     void setBrightness(uint8_t brightness);
     display_rotation_t getRotation(void) { return this->config->rotation; }
     void clear(void);
@@ -26,6 +44,9 @@ public:
     void update(int32_t start, int32_t end, bool moveCursor);
     void update(point start, point end);
     void update(rect rect);
+    void flushDirty(void);
+    void setFrameDiff(bool enabled);
+    bool getFrameDiff(void) { return this->frameDiff; }
     
     void frameCounter(void);
     bool frameLimiter(uint32_t frameRate);
@@ -36,6 +57,7 @@ public:
     uint16_t getPixel(uint32_t point);
 
     void setCursor(point point);
+    void setWindow(point start, point end);
     point getCursor(void);
     point getCenter(void);
 
@@ -48,6 +70,22 @@ public:
 
     uint16_t* getFrameBuffer(void) { return this->frameBuffer; }
 
+    void setBackBuffer(uint16_t* backBuffer);
+    bool isDoubleBuffered(void) { return this->backBuffer != nullptr; }
+    void attach(graphics* client);
+    void attach(printer* client);
+    void attach(gradient* client);
+    void present(void);
+    void swap(void);
+    bool isBusy(void) { return this->hw->isBusy(); }
+    void waitIdle(void) { this->hw->waitIdle(); }
+
+    void setDamageTracker(damageTracker* tracker);
+    damageTracker* getDamageTracker(void) { return this->damage; }
+
+    void setStrips(uint16_t* strip, uint16_t* secondStrip, uint32_t rows);
+    void render(scene* scene);
+
 protected:
     hardware_driver* hw;
     display_config_t* config;
@@ -56,6 +94,19 @@ protected:
     uint32_t pwmChannel;
     bool dataMode = false;
     uint16_t* frameBuffer;
+    uint16_t* backBuffer = nullptr;
+    damageTracker* damage = nullptr;
+
+    // frame diff, one hash per tile of the last frame that was sent
+    uint32_t* tileHashes = nullptr;
+    bool frameDiff = false;
+    bool tileHashesValid = false;
+    uint32_t diffWidth = 0;
+    uint32_t diffHeight = 0;
+
+    // band rendering, used when there is no frame buffer
+    uint16_t* strips[2] = {nullptr, nullptr};
+    uint32_t stripRows = 0;
     point cursor = {0, 0};
     bool backlight;
     uint32_t totalPixels;
@@ -65,6 +116,11 @@ protected:
     int32_t RASET;
     int32_t RAMWR;
 
+    // drawing objects rebound on every swap
+    graphics* graphicsClients[DISPLAY_MAX_CLIENTS] = {nullptr};
+    printer* printerClients[DISPLAY_MAX_CLIENTS] = {nullptr};
+    gradient* gradientClients[DISPLAY_MAX_CLIENTS] = {nullptr};
+
     // timer for the framerate calculation
     int32_t framecounter = 0;
     int32_t frames = 0;
@@ -74,7 +130,11 @@ protected:
     void writeData(uint8_t command, const uint8_t* data, size_t length);
     void writeData(uint8_t command, uint8_t data) { writeData(command, &data, 1); }
     void writeData(uint8_t command) { writeData(command, nullptr, 0); }
-    inline void columnAddressSet(uint32_t x0, uint32_t x1);
-    inline void rowAddressSet(uint32_t y0, uint32_t y1);
+    void writeCommands(const uint8_t* commands, size_t length);
+    inline void addressWindowSet(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1);
     void writePixels(const uint16_t* data, size_t length);
+    void updateDiff(void);
+    uint32_t hashTile(uint32_t tileX, uint32_t tileY);
+    void writePixelsAsync(const uint16_t* data, size_t length);
+    void writePixelsStrided(const uint16_t* data, size_t width, size_t height, size_t stride);
 };
@@ -1,5 +1,62 @@
 #include "gc9a01.hpp"
 
+// Sent before the rotation is set, see CMD_DELAY for the format
+static constexpr uint8_t initCommands[] = {
+    0xef, 0,
+    0xeb, 1, 0x14,
+    0xfe, 0,
+    0xef, 0,
+    0xeb, 1, 0x14,
+    0x84, 1, 0x40,
+    0x85, 1, 0xFF,
+    0x86, 1, 0xFF,
+    0x87, 1, 0xFF,
+    0x88, 1, 0x0A,
+    0x89, 1, 0x21,
+    0x8a, 1, 0x00,
+    0x8b, 1, 0x80,
+    0x8c, 1, 0x01,
+    0x8d, 1, 0x01,
+    0x8e, 1, 0xFF,
+    0x8f, 1, 0xFF,
+    0xb6, 2, 0x00, 0x00,
+};
+
+// Sent after the rotation is set, ends with sleep out and display on
+static constexpr uint8_t startCommands[] = {
+    0x3a, 1, 0x55,
+    0x90, 4, 0x08, 0x08, 0x08, 0x08,
+    0xbd, 1, 0x06,
+    0xbc, 1, 0x00,
+    0xff, 3, 0x60, 0x01, 0x04,
+    0xc3, 1, 0x13,
+    0xc4, 1, 0x13,
+    0xc9, 1, 0x22,
+    0xbe, 1, 0x11,
+    0xe1, 2, 0x10, 0x0E,
+    0xdf, 3, 0x21, 0x0C, 0x02,
+    0xf0, 6, 0x45, 0x09, 0x08, 0x08, 0x26, 0x2A,
+    0xf1, 6, 0x43, 0x70, 0x72, 0x36, 0x37, 0x6F,
+    0xf2, 6, 0x45, 0x09, 0x08, 0x08, 0x26, 0x2A,
+    0xf3, 6, 0x43, 0x70, 0x72, 0x36, 0x37, 0x6F,
+    0xed, 2, 0x1B, 0x0B,
+    0xae, 1, 0x77,
+    0xcd, 1, 0x63,
+    0x70, 9, 0x07, 0x07, 0x04, 0x0E, 0x0F, 0x09, 0x07, 0x08, 0x03,
+    0xe8, 1, 0x34,
+    0x62, 12, 0x18, 0x0D, 0x71, 0xED, 0x70, 0x70, 0x18, 0x0F, 0x71, 0xEF, 0x70, 0x70,
+    0x63, 12, 0x18, 0x11, 0x71, 0xF1, 0x70, 0x70, 0x18, 0x13, 0x71, 0xF3, 0x70, 0x70,
+    0x64, 7, 0x28, 0x29, 0xF1, 0x01, 0xF1, 0x00, 0x07,
+    0x66, 10, 0x3C, 0x00, 0xCD, 0x67, 0x45, 0x45, 0x10, 0x00, 0x00, 0x00,
+    0x67, 10, 0x00, 0x3C, 0x00, 0x00, 0x00, 0x01, 0x54, 0x10, 0x32, 0x98,
+    0x74, 7, 0x10, 0x85, 0x80, 0x00, 0x00, 0x4E, 0x00,
+    0x98, 2, 0x3E, 0x07,
+    0x35, 0,
+    0x21, 0,
+    0x11, CMD_DELAY, 120,
+    0x29, CMD_DELAY, 20,
+};
+
 /**
  * @brief Initialize the display
 */
@@ -14,59 +71,9 @@ void gc9a01::init()
     this->hw->reset(50);
     sleep_ms(100);
 
-    this->writeData(0xef, (const uint8_t *) NULL, 0);
-	this->writeData(0xeb, (const uint8_t *) "\x14", 1);
-    this->writeData(0xfe, (const uint8_t *) NULL, 0);
-	this->writeData(0xef, (const uint8_t *) NULL, 0);
-	this->writeData(0xeb, (const uint8_t *) "\x14", 1);
-	this->writeData(0x84, (const uint8_t *) "\x40", 1);
-	this->writeData(0x85, (const uint8_t *) "\xFF", 1);
-	this->writeData(0x86, (const uint8_t *) "\xFF", 1);
-	this->writeData(0x87, (const uint8_t *) "\xFF", 1);
-	this->writeData(0x88, (const uint8_t *) "\x0A", 1);
-	this->writeData(0x89, (const uint8_t *) "\x21", 1);
-	this->writeData(0x8a, (const uint8_t *) "\x00", 1);
-	this->writeData(0x8b, (const uint8_t *) "\x80", 1);
-	this->writeData(0x8c, (const uint8_t *) "\x01", 1);
-	this->writeData(0x8d, (const uint8_t *) "\x01", 1);
-	this->writeData(0x8e, (const uint8_t *) "\xFF", 1);
-	this->writeData(0x8f, (const uint8_t *) "\xFF", 1);
-	this->writeData(0xb6, (const uint8_t *) "\x00\x00", 2);
-	this->setRotation(this->config->rotation);
-	this->writeData(0x3a, (const uint8_t *) "\x55", 1);
-	this->writeData(0x90, (const uint8_t *) "\x08\x08\x08\x08", 4);
-	this->writeData(0xbd, (const uint8_t *) "\x06", 1);
-	this->writeData(0xbc, (const uint8_t *) "\x00", 1);
-	this->writeData(0xff, (const uint8_t *) "\x60\x01\x04", 3);
-	this->writeData(0xc3, (const uint8_t *) "\x13", 1);
-	this->writeData(0xc4, (const uint8_t *) "\x13", 1);
-	this->writeData(0xc9, (const uint8_t *) "\x22", 1);
-	this->writeData(0xbe, (const uint8_t *) "\x11", 1);
-	this->writeData(0xe1, (const uint8_t *) "\x10\x0E", 2);
-	this->writeData(0xdf, (const uint8_t *) "\x21\x0c\x02", 3);
-	this->writeData(0xf0, (const uint8_t *) "\x45\x09\x08\x08\x26\x2A", 6);
- 	this->writeData(0xf1, (const uint8_t *) "\x43\x70\x72\x36\x37\x6F", 6);
- 	this->writeData(0xf2, (const uint8_t *) "\x45\x09\x08\x08\x26\x2A", 6);
- 	this->writeData(0xf3, (const uint8_t *) "\x43\x70\x72\x36\x37\x6F", 6);
-	this->writeData(0xed, (const uint8_t *) "\x1B\x0B", 2);
-	this->writeData(0xae, (const uint8_t *) "\x77", 1);
-	this->writeData(0xcd, (const uint8_t *) "\x63", 1);
-	this->writeData(0x70, (const uint8_t *) "\x07\x07\x04\x0E\x0F\x09\x07\x08\x03", 9);
-	this->writeData(0xe8, (const uint8_t *) "\x34", 1);
-	this->writeData(0x62, (const uint8_t *) "\x18\x0D\x71\xED\x70\x70\x18\x0F\x71\xEF\x70\x70", 12);
-	this->writeData(0x63, (const uint8_t *) "\x18\x11\x71\xF1\x70\x70\x18\x13\x71\xF3\x70\x70", 12);
-	this->writeData(0x64, (const uint8_t *) "\x28\x29\xF1\x01\xF1\x00\x07", 7);
-	this->writeData(0x66, (const uint8_t *) "\x3C\x00\xCD\x67\x45\x45\x10\x00\x00\x00", 10);
-	this->writeData(0x67, (const uint8_t *) "\x00\x3C\x00\x00\x00\x01\x54\x10\x32\x98", 10);
-	this->writeData(0x74, (const uint8_t *) "\x10\x85\x80\x00\x00\x4E\x00", 7);
-    this->writeData(0x98, (const uint8_t *) "\x3e\x07", 2);
-	this->writeData(0x35, (const uint8_t *) NULL, 0);
-	this->writeData(0x21, (const uint8_t *) NULL, 0);
-	this->writeData(0x11, (const uint8_t *) NULL, 0);
-    sleep_ms(120);
-
-	this->writeData(0x29, (const uint8_t *) NULL, 0);
-	sleep_ms(20);
+    this->writeCommands(initCommands, sizeof(initCommands));
+    this->setRotation(this->config->rotation);
+    this->writeCommands(startCommands, sizeof(startCommands));
 
     // clear the display
     this->clear();
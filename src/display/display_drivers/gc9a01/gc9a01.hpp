@@ -14,14 +14,23 @@
 class gc9a01 : public display
 {
 public:
+#ifdef DISPLAY_NO_FRAMEBUFFER
+    // strip mode, everything is drawn through display::render()
     gc9a01(hardware_driver* hw, display_config_t* config) : 
-        display(hw, config, this->framebuffer, COMMAND_CASET, COMMAND_RASET, COMMAND_RAMWR) {} // Constructor
+        display(hw, config, nullptr, COMMAND_CASET, COMMAND_RASET, COMMAND_RAMWR) {} // Constructor
+#else
+    gc9a01(hardware_driver* hw, display_config_t* config) : 
+        display(hw, config, this->framebuffer, COMMAND_CASET, COMMAND_RASET, COMMAND_RAMWR, this->tileHashes) {} // Constructor
+#endif
     void init();
     void softReset();
 
     void setRotation(display_rotation_t rotation);
     void setDisplayState(bool on);
 
+#ifndef DISPLAY_NO_FRAMEBUFFER
 private:
     uint16_t framebuffer[FRAMEBUFFER_SIZE];
+    uint32_t tileHashes[DIFF_TILE_COUNT(MAX_WIDTH, MAX_HEIGHT)];
+#endif
 };
\ No newline at end of file
@@ -1,25 +1,26 @@
 #include "st7789.hpp"
 
+// Sent before the rotation is set, see CMD_DELAY for the format
+static constexpr uint8_t initCommands[] = {
+    0x01, CMD_DELAY, 100,   // software reset
+    0x11, CMD_DELAY, 50,    // sleep out
+    0x3a, 1, 0x5 << 4 | 0x5, // 65k of rgb interface, 16 bits per pixel
+};
+
+// Sent after the rotation is set
+static constexpr uint8_t startCommands[] = {
+    0x21, 0,                // display inversion on
+    0x13, 0,                // normal display mode on
+};
+
 void st7789::init()
 {    
     // Apply constants
     this->maxWidth = MAX_WIDTH;
     this->maxHeight = MAX_HEIGHT;
 
-    // reset the display
-    this->writeData(0x01, NULL, 0);
-    sleep_ms(100);
-
-    // set the display to sleep out
-    this->writeData(0x11, NULL, 0);
-    sleep_ms(50);
-
-    // set the display to interface pixel format
-    // 0x5 << 4 = 65k of rgb interface
-    // 0x5 = 16 bits per pixel
-    unsigned char pixelFormat = 0x5 << 4 | 0x5;
-    this->writeData(0x3a, &pixelFormat, 1);
-    sleep_ms(10);
+    // reset, wake up and set the pixel format
+    this->writeCommands(initCommands, sizeof(initCommands));
 
     // madctl = memory access control
     this->setRotation(this->config->rotation);
@@ -27,13 +28,8 @@ void st7789::init()
     // set the display to memory access control
     this->setCursor({0, 0});
 
-    // display inversion on
-    this->writeData(0x21, NULL, 0);
-    sleep_ms(10);
-
-    // normal display mode on
-    this->writeData(0x13, NULL, 0);
-    sleep_ms(10);
+    // inversion and normal mode
+    this->writeCommands(startCommands, sizeof(startCommands));
 
     // clear the display
     this->clear();
@@ -14,13 +14,22 @@
 class st7789 : public display
 {
 public:
+#ifdef DISPLAY_NO_FRAMEBUFFER
+    // strip mode, everything is drawn through display::render()
     st7789(hardware_driver* hw, display_config_t* config) : 
-        display(hw, config, this->framebuffer, COMMAND_CASET, COMMAND_RASET, COMMAND_RAMWR) {} // Constructor
+        display(hw, config, nullptr, COMMAND_CASET, COMMAND_RASET, COMMAND_RAMWR) {} // Constructor
+#else
+    st7789(hardware_driver* hw, display_config_t* config) : 
+        display(hw, config, this->framebuffer, COMMAND_CASET, COMMAND_RASET, COMMAND_RAMWR, this->tileHashes) {} // Constructor
+#endif
     void init();
 
     void setRotation(display_rotation_t rotation);
     void setDisplayState(bool on);
 
+#ifndef DISPLAY_NO_FRAMEBUFFER
 private:
     uint16_t framebuffer[FRAMEBUFFER_SIZE];
+    uint32_t tileHashes[DIFF_TILE_COUNT(MAX_WIDTH, MAX_HEIGHT)];
+#endif
 };
\ No newline at end of file
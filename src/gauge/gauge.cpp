@@ -64,6 +64,8 @@ void dialGauge::attachBackgroundColor(color value)
  */
 void dialGauge::drawLine(int32_t value, int32_t width, color color)
 {
+	PROFILE_SCOPE("dialGauge::drawLine", this->radius * width);
+
 	// Make sure the thickness is above 0 
 	if (width <= 0) width = 1;
 	// Find the angle based of the value
@@ -79,7 +81,7 @@ void dialGauge::drawLine(int32_t value, int32_t width, color color)
 	point end = this->center;
 	end = this->getPointOnCircle(end, this->radius, angle);
 	// Draw the line
-	this->graphics_ptr->drawLineAntiAliased(start, end, color);
+	this->graphics_ptr->drawLineThickAntiAliased(start, end, width, color);
 }
 
 /**
@@ -88,6 +90,8 @@ void dialGauge::drawLine(int32_t value, int32_t width, color color)
  */
 void dialGauge::update(int32_t value)
 {
+	PROFILE_SCOPE("dialGauge::update", profileCircleArea(this->radius) * this->angle / 360);
+
 	// Draw the dial
 	switch (this->type)
 	{
@@ -163,8 +167,7 @@ void dialGauge::drawNeedle(int32_t value)
 		point p2 = { center.x + x2, center.y + y2 };
 
 		// Draw the needle
-		point points[] = { p1, p2, endPoint };
-		this->graphics_ptr->drawFilledPolygon(points, 3, this->needleColor);
+		this->graphics_ptr->drawFilledTriangle(p1, p2, endPoint, this->needleColor);
 	}
 }
 
@@ -16,6 +16,32 @@ gradient::gradient(uint16_t* frameBuffer, display_config_t* config)
     this->theta = 0;
 }
 
+/**
+ * @brief Point the object at a whole frame buffer
+ * @param frameBuffer Buffer of width * height pixels
+ * @note Removes the band set by setBand()
+*/
+void gradient::setFrameBuffer(uint16_t* frameBuffer)
+{
+    this->frameBuffer = frameBuffer;
+    this->bandTop = 0;
+    this->bandBottom = INT32_MAX;
+}
+
+/**
+ * @brief Draw into a strip of rows instead of a whole frame buffer
+ * @param buffer Buffer of width * rows pixels
+ * @param top First display row held by the buffer
+ * @param rows Number of rows in the buffer
+*/
+void gradient::setBand(uint16_t* buffer, int32_t top, uint32_t rows)
+{
+    // offset the buffer so display coordinates index straight into the strip
+    this->frameBuffer = buffer - top * (int32_t)this->config->width;
+    this->bandTop = top;
+    this->bandBottom = top + (int32_t)rows;
+}
+
 /**
  * @brief Fill the display with a color gradient
  * @param startColor color to start with
@@ -37,13 +63,22 @@ void gradient::fillGradient(color startColor, color endColor, rect area)
 */
 void gradient::fillGradient(color startColor, color endColor, point start, point end)
 {
+    PROFILE_SCOPE("fillGradient", this->config->width * this->config->height);
+
+    // the gradient always covers the entire display
+    if (this->damage != nullptr)
+        this->damage->addAll();
+
+    // only the rows in the band are filled
+    int32_t firstY = imax(this->bandTop, 0);
+    int32_t lastY = imin(this->bandBottom, (int32_t)this->config->height);
+
     // check if the start and end Points are the same
     if(start == end)
     {
         uint16_t startColor16 = startColor.to16bit(this->config->inverseColors);
-        uint32_t totalPixels = this->config->width * this->config->height;
-        for(int32_t i = 0; i < totalPixels; i++)
-            this->frameBuffer[i] = startColor16;
+        if (lastY > firstY)
+            fillSpan(this->frameBuffer + firstY * this->config->width, startColor16, (lastY - firstY) * this->config->width);
 
         return;
     }
@@ -78,7 +113,7 @@ void gradient::fillGradient(color startColor, color endColor, point start, point
     // loop through each pixel in the buffer
     for(int32_t x = 0; x < this->config->width; x++)
     {
-        for (int32_t y = 0; y < this->config->height; y++)
+        for (int32_t y = firstY; y < lastY; y++)
         {
             // calculate the vector from the start to the current pixel
             int32_t vectorX = x - start.x;
@@ -121,6 +156,8 @@ void gradient::drawRotCircleGradient(circle c, int32_t rotationSpeed, color star
 */
 void gradient::drawRotCircleGradient(point center, int32_t radius, int32_t rotationSpeed, color start, color end)
 {
+    PROFILE_SCOPE("drawRotCircleGradient", this->config->width * this->config->height);
+
     this->theta += rotationSpeed;
     this->theta = this->theta % 360;
 
@@ -153,6 +190,8 @@ void gradient::drawRotCircleGradient(point center, int32_t radius, int32_t rotat
 */
 void gradient::drawRotRectGradient(point center, int32_t width, int32_t height, int32_t rotationSpeed, color start, color end)
 {
+    PROFILE_SCOPE("drawRotRectGradient", this->config->width * this->config->height);
+
     this->theta += rotationSpeed;
     this->theta = this->theta % 360;
     point rotGradStart, rotGradEnd;
@@ -4,6 +4,9 @@
 #include "display_struct.h"
 #include "shapes.hpp"
 #include "gfxmath.h"
+#include "span.h"
+#include "damage.hpp"
+#include "profiler.hpp"
 
 class gradient
 {
@@ -16,9 +19,18 @@ public:
     void drawRotCircleGradient(point center, int32_t radius, int32_t rotationSpeed, color start, color end);
     void drawRotRectGradient(point center, int32_t width, int32_t height, int32_t rotationSpeed, color start, color end);
     void drawRotRectGradient(point center, rect area, int32_t rotationSpeed, color start, color end);
+
+    void setFrameBuffer(uint16_t* frameBuffer);
+    uint16_t* getFrameBuffer(void) { return this->frameBuffer; }
+    void setBand(uint16_t* buffer, int32_t top, uint32_t rows);
+    void setDamageTracker(damageTracker* tracker) { this->damage = tracker; }
 private:
     uint16_t* frameBuffer;
     display_config_t* config;
+    damageTracker* damage = nullptr;
+    // rows that can be drawn to, the whole display unless a band is set
+    int32_t bandTop = 0;
+    int32_t bandBottom = INT32_MAX;
     size_t totalPixels;
 
     uint32_t theta; // The angle of the rotating gradient
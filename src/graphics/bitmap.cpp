@@ -83,18 +83,22 @@ void graphics::drawBitmap(const uint8_t* bitmap, uint32_t width, uint32_t height
 */
 void graphics::drawBitmap(const uint16_t* bitmap, uint32_t width, uint32_t height, point start)
 {
+    PROFILE_SCOPE("drawBitmap", width * height);
+
     int startX = start.x;
     int startY = start.y;
 
-    if (startX >= (int)this->config->width || startY >= (int)this->config->height 
-        || startX + (int)width <= 0 || startY + (int)height <= 0)
+    this->markDamage(startX, startY, startX + (int)width - 1, startY + (int)height - 1);
+
+    clip_t area = this->getClipArea();
+    if (this->rejectClip(area, startX, startY, startX + (int)width - 1, startY + (int)height - 1))
         return;
 
-    int offsetX = imax(-startX, 0);
-    int offsetY = imax(-startY, 0);
+    int offsetX = imax(area.left - startX, 0);
+    int offsetY = imax(area.top - startY, 0);
 
-    int endX = imin(startX + (int)width, (int)this->config->width);
-    int endY = imin(startY + (int)height, (int)this->config->height);
+    int endX = imin(startX + (int)width, area.right);
+    int endY = imin(startY + (int)height, area.bottom);
 
     for (int y = startY + offsetY, by = offsetY; y < endY; ++y, ++by)
     {
@@ -112,4 +116,91 @@ void graphics::drawBitmap(const uint16_t* bitmap, uint32_t width, uint32_t heigh
             this->frameBuffer[y * this->config->width + x] = color16;
         }
     }
+}
+
+/**
+ * @brief Draw a see-through 16 bit bitmap on the display
+ * @param bitmap Array containing the bitmap
+ * @param width Width of the bitmap
+ * @param height Height of the bitmap
+ * @param start Where to start the drawing
+ * @param alpha Alpha value of the whole bitmap, 0 is transparent, 255 is opaque
+*/
+void graphics::drawBitmap(const uint16_t* bitmap, uint32_t width, uint32_t height, point start, uint8_t alpha)
+{
+    PROFILE_SCOPE("drawBitmap alpha", width * height);
+
+    this->blendBitmap(bitmap, nullptr, spanAlpha(alpha), width, height, start);
+}
+
+/**
+ * @brief Draw a 16 bit bitmap with an alpha for every pixel on the display
+ * @param bitmap Array containing the bitmap
+ * @param mask Array containing the alpha of every pixel of the bitmap, 0 is transparent, 255 is opaque
+ * @param width Width of the bitmap
+ * @param height Height of the bitmap
+ * @param start Where to start the drawing
+*/
+void graphics::drawBitmapMasked(const uint16_t* bitmap, const uint8_t* mask, uint32_t width, uint32_t height, point start)
+{
+    PROFILE_SCOPE("drawBitmapMasked", width * height);
+
+    this->blendBitmap(bitmap, mask, SPAN_ALPHA_MAX, width, height, start);
+}
+
+/**
+ * @private
+ * @brief Blend a bitmap over the display, clipped to the display and the band
+ * @param bitmap Array containing the bitmap
+ * @param mask Alpha of every pixel, nullptr to use alpha for the whole bitmap
+ * @param alpha Alpha from 0 to SPAN_ALPHA_MAX, used when there is no mask
+ * @param width Width of the bitmap
+ * @param height Height of the bitmap
+ * @param start Where to start the drawing
+*/
+void graphics::blendBitmap(const uint16_t* bitmap, const uint8_t* mask, uint32_t alpha, uint32_t width, uint32_t height, point start)
+{
+    int startX = start.x;
+    int startY = start.y;
+
+    this->markDamage(startX, startY, startX + (int)width - 1, startY + (int)height - 1);
+
+    clip_t area = this->getClipArea();
+    if (this->rejectClip(area, startX, startY, startX + (int)width - 1, startY + (int)height - 1))
+        return;
+
+    int offsetX = imax(area.left - startX, 0);
+    int offsetY = imax(area.top - startY, 0);
+
+    int endX = imin(startX + (int)width, area.right);
+    int endY = imin(startY + (int)height, area.bottom);
+
+    // the pixels are blended in chunks so inverted colors can be converted first
+    uint16_t chunk[32];
+    for (int y = startY + offsetY, by = offsetY; y < endY; ++y, ++by)
+    {
+        for (int x = startX + offsetX, bx = offsetX; x < endX; x += 32, bx += 32)
+        {
+            size_t length = imin(endX - x, 32);
+            const uint16_t* source = &bitmap[by * width + bx];
+            if (this->config->inverseColors)
+            {
+                for (size_t i = 0; i < length; i++)
+                {
+                    uint16_t color16 = source[i];
+                    color16 = ((color16 & 0xaaaa) >> 1) | ((color16 & 0x5555) << 1);
+                    color16 = ((color16 & 0xcccc) >> 2) | ((color16 & 0x3333) << 2);
+                    color16 = ((color16 & 0xf0f0) >> 4) | ((color16 & 0x0f0f) << 4);
+                    chunk[i] = (color16 >> 8) | (color16 << 8);
+                }
+                source = chunk;
+            }
+
+            uint16_t* destination = &this->frameBuffer[y * this->config->width + x];
+            if (mask != nullptr)
+                blendCopyMasked(destination, source, &mask[by * width + bx], length);
+            else
+                blendCopy(destination, source, alpha, length);
+        }
+    }
 }
\ No newline at end of file
@@ -1,5 +1,362 @@
 #include "graphics.hpp"
 
+// Columns standing in for no limit on a row, far enough from the int32_t range to step past
+#define SECTOR_MIN (INT32_MIN / 2)
+#define SECTOR_MAX (INT32_MAX / 2)
+
+// The two rays bounding a filled arc, in 16.16 fixed point
+typedef struct
+{
+    int32_t startX;
+    int32_t startY;
+    int32_t endX;
+    int32_t endY;
+    bool wide;  // more than half a turn, the sides of the rays are joined instead of intersected
+    bool full;  // a whole turn, the rays do not limit anything
+} sector_t;
+
+/**
+ * @brief Divide and round down
+ * @param numerator Number to divide
+ * @param denominator Number to divide by, not 0
+ * @return int32_t The quotient, rounded towards negative infinity
+*/
+static inline int32_t sectorFloor(int32_t numerator, int32_t denominator)
+{
+    int32_t quotient = numerator / denominator;
+    if (numerator % denominator != 0 && (numerator < 0) != (denominator < 0))
+        quotient--;
+    return quotient;
+}
+
+/**
+ * @brief Get the columns of a row that lie less than half a turn clockwise of a ray
+ * @param rayX X of the ray direction
+ * @param rayY Y of the ray direction
+ * @param dy Row relative to the center
+ * @param span Gets the first and last column relative to the center, first > last if there are none
+ * @note Clockwise on the display, where y points down, is the direction the angles grow in.
+ *       Pixels on the ray are on the side, pixels on its extension past the center are not,
+ *       and the center counts as the pixel right of it
+*/
+static void sectorSide(int32_t rayX, int32_t rayY, int32_t dy, int32_t* span)
+{
+    span[0] = SECTOR_MIN;
+    span[1] = SECTOR_MAX;
+
+    // the row through the center is at 0 degrees right of it and 180 degrees left of it
+    if (dy == 0)
+    {
+        if (rayY < 0 || (rayY == 0 && rayX > 0))
+            span[0] = 0;
+        else
+            span[1] = -1;
+        return;
+    }
+
+    // the pixel is on the side when rayX * dy - rayY * dx >= 0, which bounds dx from one side,
+    // a pixel right on that line is only kept when it points the same way as the ray
+    int32_t bound = rayX * dy;
+    if (rayY > 0)
+    {
+        span[1] = sectorFloor(bound, rayY);
+        if (bound % rayY == 0 && dy < 0)
+            span[1]--;
+    }
+    else if (rayY < 0)
+    {
+        span[0] = -sectorFloor(-bound, rayY);
+        if (bound % rayY == 0 && dy > 0)
+            span[0]++;
+    }
+    else if (bound < 0)
+    {
+        span[0] = SECTOR_MAX;
+        span[1] = SECTOR_MIN;
+    }
+}
+
+/**
+ * @brief Set up the rays between two angles
+ * @param sector Sector to set up
+ * @param startAngle Angle in degrees the sector starts at, included in it
+ * @param endAngle Angle in degrees the sector ends at, not included in it
+ * @return bool False if the sector is empty
+*/
+static bool sectorSetup(sector_t* sector, int32_t startAngle, int32_t endAngle)
+{
+    // the angles may come in as negative degrees
+    int32_t sweep = inorm(endAngle - startAngle);
+    sector->full = sweep == 0;
+    sector->wide = sweep > 180;
+    if (sector->full && endAngle == startAngle)
+        return false;
+
+    // both rays come from the same table, so arcs sharing an angle split the pixels exactly
+    sector->startX = icosd(startAngle * ANGLE_STEP);
+    sector->startY = isind(startAngle * ANGLE_STEP);
+    sector->endX = icosd(endAngle * ANGLE_STEP);
+    sector->endY = isind(endAngle * ANGLE_STEP);
+    return true;
+}
+
+/**
+ * @brief Get the columns of a row that lie between the rays of a sector
+ * @param sector Sector to check
+ * @param dy Row relative to the center
+ * @param spans Gets up to two pairs of first and last columns relative to the center
+ * @return size_t Number of pairs
+*/
+static size_t sectorSpans(const sector_t& sector, int32_t dy, int32_t* spans)
+{
+    if (sector.full)
+    {
+        spans[0] = SECTOR_MIN;
+        spans[1] = SECTOR_MAX;
+        return 1;
+    }
+
+    // after the start ray and before the end ray, where before is everything not after it
+    int32_t after[2];
+    int32_t end[2];
+    int32_t before[2];
+    sectorSide(sector.startX, sector.startY, dy, after);
+    sectorSide(sector.endX, sector.endY, dy, end);
+    if (end[0] > end[1])
+    {
+        before[0] = SECTOR_MIN;
+        before[1] = SECTOR_MAX;
+    }
+    else if (end[0] == SECTOR_MIN && end[1] == SECTOR_MAX)
+    {
+        before[0] = SECTOR_MAX;
+        before[1] = SECTOR_MIN;
+    }
+    else if (end[0] == SECTOR_MIN)
+    {
+        before[0] = end[1] + 1;
+        before[1] = SECTOR_MAX;
+    }
+    else
+    {
+        before[0] = SECTOR_MIN;
+        before[1] = end[0] - 1;
+    }
+
+    if (!sector.wide)
+    {
+        spans[0] = imax(after[0], before[0]);
+        spans[1] = imin(after[1], before[1]);
+        return spans[0] <= spans[1] ? 1 : 0;
+    }
+
+    // past half a turn the sector is the union, joined into one span where the two touch
+    size_t count = 0;
+    if (after[0] <= after[1])
+    {
+        spans[0] = after[0];
+        spans[1] = after[1];
+        count++;
+    }
+    if (before[0] <= before[1])
+    {
+        if (count == 1 && before[0] <= spans[1] + 1 && spans[0] <= before[1] + 1)
+        {
+            spans[0] = imin(spans[0], before[0]);
+            spans[1] = imax(spans[1], before[1]);
+        }
+        else
+        {
+            spans[2 * count] = before[0];
+            spans[2 * count + 1] = before[1];
+            count++;
+        }
+    }
+    return count;
+}
+
+// A ring, or the part of it between two angles, drawn with anti-aliasing
+typedef struct
+{
+    sector_t sector;
+    int32_t outer;      // doubled radius of the outer edge
+    int32_t inner;      // doubled radius of the inner edge, 0 or less when there is no hole
+    int32_t x;          // column of the center
+    int32_t left;       // first column that can be drawn, relative to the center
+    int32_t right;      // last column that can be drawn, relative to the center
+    uint16_t color;
+} ring_t;
+
+/**
+ * @brief Get how much of a pixel lies inside a ring
+ * @param ring Ring to check
+ * @param dx Column relative to the center
+ * @param dy Row relative to the center
+ * @return int32_t Coverage from 0 to COVERAGE_MAX
+*/
+static int32_t ringPixel(const ring_t& ring, int32_t dx, int32_t dy)
+{
+    int64_t distance = 4 * ((int64_t)dx * dx + (int64_t)dy * dy);
+    int32_t coverage = icoverage(ring.outer, distance);
+    if (ring.inner > 0)
+        coverage -= icoverage(ring.inner, distance);
+    if (coverage <= 0 || ring.sector.full)
+        return coverage;
+
+    // the rays are straight edges, the coverage follows the distance to them in 16.16
+    int32_t half = COVERAGE_MAX / 2;
+    int32_t after = clamp(half + ((ring.sector.startX * dy - ring.sector.startY * dx) >> 8), 0, COVERAGE_MAX);
+    int32_t before = COVERAGE_MAX - clamp(half + ((ring.sector.endX * dy - ring.sector.endY * dx) >> 8), 0, COVERAGE_MAX);
+    int32_t angular = ring.sector.wide ? imax(after, before) : imin(after, before);
+    return coverage * angular / COVERAGE_MAX;
+}
+
+/**
+ * @brief Get the columns of a row a ray covers part of
+ * @param rayX X of the ray direction
+ * @param rayY Y of the ray direction
+ * @param dy Row relative to the center
+ * @param band Gets the first and last column relative to the center, first > last if there are none
+ * @note The columns may include a pixel the ray just misses
+*/
+static void ringRayBand(int32_t rayX, int32_t rayY, int32_t dy, int32_t* band)
+{
+    // a pixel is partly covered when rayX * dy - rayY * dx is within half a pixel of 0
+    int32_t bound = rayX * dy;
+    int32_t half = 1 << (SIN_MULTIPLIER_BITS - 1);
+    if (rayY == 0)
+    {
+        band[0] = iabs(bound) < half ? SECTOR_MIN : SECTOR_MAX;
+        band[1] = iabs(bound) < half ? SECTOR_MAX : SECTOR_MIN;
+        return;
+    }
+
+    int32_t first = sectorFloor(bound - half, rayY);
+    int32_t last = sectorFloor(bound + half, rayY);
+    band[0] = imin(first, last);
+    band[1] = imax(first, last) + 1;
+}
+
+/**
+ * @brief Blend the pixels of a row that a ring covers part of
+ * @param row First pixel of the row
+ * @param ring Ring to draw
+ * @param dy Row relative to the center
+ * @param x1 First column relative to the center
+ * @param x2 Last column relative to the center
+*/
+static void ringBlend(uint16_t* row, const ring_t& ring, int32_t dy, int32_t x1, int32_t x2)
+{
+    x1 = imax(x1, ring.left);
+    x2 = imin(x2, ring.right);
+    for (int32_t x = x1; x <= x2; x++)
+    {
+        uint32_t alpha = (ringPixel(ring, x, dy) * SPAN_ALPHA_MAX + COVERAGE_MAX / 2) / COVERAGE_MAX;
+        if (alpha > 0)
+            row[ring.x + x] = blendPixel(row[ring.x + x], ring.color, alpha);
+    }
+}
+
+/**
+ * @brief Fill the pixels of a row that lie in the sector of a ring, the rays are not blended
+ * @param row First pixel of the row
+ * @param ring Ring to draw
+ * @param dy Row relative to the center
+ * @param x1 First column relative to the center
+ * @param x2 Last column relative to the center
+*/
+static void ringSector(uint16_t* row, const ring_t& ring, int32_t dy, int32_t x1, int32_t x2)
+{
+    int32_t spans[4];
+    size_t count = sectorSpans(ring.sector, dy, spans);
+    for (size_t i = 0; i < count; i++)
+    {
+        int32_t first = imax(spans[2 * i], x1);
+        int32_t last = imin(spans[2 * i + 1], x2);
+        if (first <= last)
+            fillSpan(row + ring.x + first, ring.color, last - first + 1);
+    }
+}
+
+/**
+ * @brief Fill the pixels of a row that lie fully between the edges of a ring
+ * @param row First pixel of the row
+ * @param ring Ring to draw
+ * @param dy Row relative to the center
+ * @param x1 First column relative to the center
+ * @param x2 Last column relative to the center
+*/
+static void ringFill(uint16_t* row, const ring_t& ring, int32_t dy, int32_t x1, int32_t x2)
+{
+    x1 = imax(x1, ring.left);
+    x2 = imin(x2, ring.right);
+    if (x1 > x2)
+        return;
+
+    if (ring.sector.full)
+    {
+        fillSpan(row + ring.x + x1, ring.color, x2 - x1 + 1);
+        return;
+    }
+
+    // the pixels the rays cross are blended, the rest is either in the sector or not
+    int32_t bands[4];
+    ringRayBand(ring.sector.startX, ring.sector.startY, dy, bands);
+    ringRayBand(ring.sector.endX, ring.sector.endY, dy, bands + 2);
+    if (bands[2] < bands[0])
+    {
+        int32_t swap[2] = { bands[0], bands[1] };
+        bands[0] = bands[2];
+        bands[1] = bands[3];
+        bands[2] = swap[0];
+        bands[3] = swap[1];
+    }
+
+    int32_t x = x1;
+    for (size_t i = 0; i < 2; i++)
+    {
+        int32_t first = bands[2 * i];
+        int32_t last = bands[2 * i + 1];
+        if (first > last || last < x)
+            continue;
+        if (first > x2)
+            break;
+
+        ringSector(row, ring, dy, x, first - 1);
+        ringBlend(row, ring, dy, imax(first, x), imin(last, x2));
+        x = last + 1;
+    }
+    ringSector(row, ring, dy, x, x2);
+}
+
+/**
+ * @brief Draw both halves of a row of a ring
+ * @param row First pixel of the row
+ * @param ring Ring to draw
+ * @param dy Row relative to the center
+ * @param hole Last column fully inside the hole, -1 if there is none
+ * @param holeEdge Last column the hole covers part of, -1 if there is none
+ * @param solid Last column fully inside the outer edge
+ * @param edge Last column the outer edge covers part of
+ * @note The columns are counted from the center, the left half leaves out the center column
+*/
+static void ringRow(uint16_t* row, const ring_t& ring, int32_t dy, int32_t hole, int32_t holeEdge, int32_t solid, int32_t edge)
+{
+    if (holeEdge >= solid)
+    {
+        ringBlend(row, ring, dy, -edge, -imax(hole + 1, 1));
+        ringBlend(row, ring, dy, hole + 1, edge);
+        return;
+    }
+
+    ringBlend(row, ring, dy, -edge, -imax(solid + 1, 1));
+    ringFill(row, ring, dy, -solid, -imax(holeEdge + 1, 1));
+    ringBlend(row, ring, dy, -holeEdge, -imax(hole + 1, 1));
+    ringBlend(row, ring, dy, hole + 1, holeEdge);
+    ringFill(row, ring, dy, holeEdge + 1, solid);
+    ringBlend(row, ring, dy, solid + 1, edge);
+}
+
 /**
  * @brief Draw a circle on the display
  * @param c Circle to draw
@@ -19,6 +376,11 @@ void graphics::drawCircle(circle c, color color, uint32_t thickness)
 */
 void graphics::drawCircle(point center, uint32_t radius, color color, uint32_t thickness)
 {
+    PROFILE_SCOPE("drawCircle", (710 * radius / 113) * thickness);
+
+    int32_t reach = (int32_t)(radius + thickness);
+    this->markDamage(center.x - reach, center.y - reach, center.x + reach, center.y + reach);
+
     if (thickness == 0 || thickness == 1)
         this->drawCircle1(center, radius, color);
     else
@@ -43,65 +405,29 @@ void graphics::drawFilledCircle(circle c, color color)
 */
 void graphics::drawFilledCircle(point center, uint32_t radius, color color)
 {
-    // Uses a modified Bresenham's circle algorithm
-    // https://en.wikipedia.org/wiki/Midpoint_circle_algorithm
-
-    // move Points into local variables
-    int32_t x0 = center.x;
-    int32_t y0 = center.y;
-    int32_t x = radius;
-    int32_t y = 0;
-    int32_t error = 3 - 2 * x;
+    PROFILE_SCOPE("drawFilledCircle", profileCircleArea(radius));
 
-    // convert the color to 16 bit
-    uint16_t color16 = color.to16bit(this->config->inverseColors);
-    uint32_t totalPixels = this->config->width * this->config->height;
+    this->markDamage(center.x - (int32_t)radius, center.y - (int32_t)radius, center.x + (int32_t)radius, center.y + (int32_t)radius);
 
-    while (y <= x)
-    {
-        for (int32_t i = x0 - x; i <= x0 + x; i++)
-        {
-            int32_t index1 = (y0 + y) * this->config->width + i;
-            int32_t index2 = (y0 - y) * this->config->width + i;
-            
-            if (index1 >= 0 && index1 < totalPixels)
-            {
-                this->frameBuffer[index1] = color16;
-            }
-            
-            if (index2 >= 0 && index2 < totalPixels)
-            {
-                this->frameBuffer[index2] = color16;
-            }
-        }
-        
-        for (int32_t i = x0 - y; i <= x0 + y; i++)
-        {
-            int32_t index1 = (y0 + x) * this->config->width + i;
-            int32_t index2 = (y0 - x) * this->config->width + i;
+    clip_t area = this->getClipArea();
+    this->fillCircleRows(area, center.x, center.y, center.x, center.y, radius, color.to16bit(this->config->inverseColors));
+}
 
-            if (index1 >= 0 && index1 < totalPixels)
-            {
-                this->frameBuffer[index1] = color16;
-            }
-            
-            if (index2 >= 0 && index2 < totalPixels)
-            {
-                this->frameBuffer[index2] = color16;
-            }
-        }
+/**
+ * @brief Draw a filled ellipse on the display
+ * @param center Center point
+ * @param radiusX Horizontal radius of the ellipse
+ * @param radiusY Vertical radius of the ellipse
+ * @param color color to draw in
+*/
+void graphics::drawFilledEllipse(point center, uint32_t radiusX, uint32_t radiusY, color color)
+{
+    PROFILE_SCOPE("drawFilledEllipse", (355 * radiusX * radiusY) / 113);
 
-        y++;
+    this->markDamage(center.x - (int32_t)radiusX, center.y - (int32_t)radiusY, center.x + (int32_t)radiusX, center.y + (int32_t)radiusY);
 
-        // Update the error
-        if (error > 0) 
-        {
-            x--;
-            error += 4 * (y - x) + 10;
-        }
-        else
-            error += 4 * y + 6;
-    }
+    clip_t area = this->getClipArea();
+    this->fillEllipseRows(area, center.x, center.y, center.x, center.y, radiusX, radiusY, color.to16bit(this->config->inverseColors));
 }
 
 /**
@@ -127,6 +453,8 @@ void graphics::drawFilledCircleWithStroke(circle c, color fillColor, color strok
  */
 void graphics::drawFilledCircleWithStroke(point center, uint32_t radius, color fillColor, color strokeColor, uint32_t strokeThickness)
 {
+    PROFILE_SCOPE("drawFilledCircleWithStroke", profileCircleArea(radius));
+
     this->drawFilledCircle(center, radius, fillColor);
     this->drawCircle(center, radius, strokeColor, strokeThickness);
 }
@@ -141,8 +469,8 @@ void graphics::drawFilledCircleWithStroke(point center, uint32_t radius, color f
 void graphics::drawCircle1(point center, uint32_t radius, color color)
 {
     // move Points into local variables
-    uint32_t x0 = center.x;
-    uint32_t y0 = center.y;
+    int32_t x0 = center.x;
+    int32_t y0 = center.y;
     int32_t x = radius;
     int32_t y = 0;
     int32_t error = 3 - 2 * x;
@@ -150,18 +478,38 @@ void graphics::drawCircle1(point center, uint32_t radius, color color)
     // convert the color to 16 bit
     uint16_t color16 = color.to16bit(this->config->inverseColors);
 
+    // circles outside of the clip area are skipped, circles inside it need no checks per pixel
+    clip_t area = this->getClipArea();
+    if (this->rejectClip(area, x0 - x, y0 - x, x0 + x, y0 + x))
+        return;
+    bool inside = this->insideClip(area, x0 - x, y0 - x, x0 + x, y0 + x);
+
     // loop through the radius
     while(x >= y)
     {
-        // draw the pixels in the frame buffer
-        this->frameBuffer[(x0 + x) + (y0 + y) * this->config->width] = color16;
-        this->frameBuffer[(x0 + y) + (y0 + x) * this->config->width] = color16;
-        this->frameBuffer[(x0 - y) + (y0 + x) * this->config->width] = color16;
-        this->frameBuffer[(x0 - x) + (y0 + y) * this->config->width] = color16;
-        this->frameBuffer[(x0 - x) + (y0 - y) * this->config->width] = color16;
-        this->frameBuffer[(x0 - y) + (y0 - x) * this->config->width] = color16;
-        this->frameBuffer[(x0 + y) + (y0 - x) * this->config->width] = color16;
-        this->frameBuffer[(x0 + x) + (y0 - y) * this->config->width] = color16;
+        // draw the pixels in the frame buffer, one row pair at a time
+        if (inside)
+        {
+            this->frameBuffer[(x0 + x) + (y0 + y) * this->config->width] = color16;
+            this->frameBuffer[(x0 - x) + (y0 + y) * this->config->width] = color16;
+            this->frameBuffer[(x0 + y) + (y0 + x) * this->config->width] = color16;
+            this->frameBuffer[(x0 - y) + (y0 + x) * this->config->width] = color16;
+            this->frameBuffer[(x0 - x) + (y0 - y) * this->config->width] = color16;
+            this->frameBuffer[(x0 + x) + (y0 - y) * this->config->width] = color16;
+            this->frameBuffer[(x0 - y) + (y0 - x) * this->config->width] = color16;
+            this->frameBuffer[(x0 + y) + (y0 - x) * this->config->width] = color16;
+        }
+        else
+        {
+            this->setPixel(x0 + x, y0 + y, color16);
+            this->setPixel(x0 - x, y0 + y, color16);
+            this->setPixel(x0 + y, y0 + x, color16);
+            this->setPixel(x0 - y, y0 + x, color16);
+            this->setPixel(x0 - x, y0 - y, color16);
+            this->setPixel(x0 + x, y0 - y, color16);
+            this->setPixel(x0 - y, y0 - x, color16);
+            this->setPixel(x0 + y, y0 - x, color16);
+        }
         
         // if the error is greater than 0
         if(error > 0)
@@ -196,22 +544,26 @@ void graphics::drawCircle2(point center, uint32_t radius, color color, uint32_t
     uint32_t x_outer = radius + thickness_mod;
     uint32_t x_inner = radius - thickness_mod;
     uint32_t y = 0;
-    uint32_t x0 = center.x;
-    uint32_t y0 = center.y;
+    int32_t x0 = center.x;
+    int32_t y0 = center.y;
     int32_t erro = 1 - x_outer;
     int32_t erri = 1 - x_inner;
     uint16_t color16 = color.to16bit(this->config->inverseColors);
 
+    clip_t area = this->getClipArea();
+    if (this->rejectClip(area, x0 - (int32_t)x_outer, y0 - (int32_t)x_outer, x0 + (int32_t)x_outer, y0 + (int32_t)x_outer))
+        return;
+
     while (x_outer >= y)
     {
-        this->drawCircleXLine(x0 + x_inner, x0 + x_outer, y0 + y,  color);
-        this->drawCircleYLine(x0 + y,  y0 + x_inner, y0 + x_outer, color);
-        this->drawCircleXLine(x0 - x_outer, x0 - x_inner, y0 + y,  color);
-        this->drawCircleYLine(x0 - y,  y0 + x_inner, y0 + x_outer, color);
-        this->drawCircleXLine(x0 - x_outer, x0 - x_inner, y0 - y,  color);
-        this->drawCircleYLine(x0 - y,  y0 - x_outer, y0 - x_inner, color);
-        this->drawCircleXLine(x0 + x_inner, x0 + x_outer, y0 - y,  color);
-        this->drawCircleYLine(x0 + y,  y0 - x_outer, y0 - x_inner, color);
+        this->drawCircleXLine(area, x0 + x_inner, x0 + x_outer, y0 + y,  color16);
+        this->drawCircleYLine(area, x0 + y,  y0 + x_inner, y0 + x_outer, color16);
+        this->drawCircleXLine(area, x0 - x_outer, x0 - x_inner, y0 + y,  color16);
+        this->drawCircleYLine(area, x0 - y,  y0 + x_inner, y0 + x_outer, color16);
+        this->drawCircleXLine(area, x0 - x_outer, x0 - x_inner, y0 - y,  color16);
+        this->drawCircleYLine(area, x0 - y,  y0 - x_outer, y0 - x_inner, color16);
+        this->drawCircleXLine(area, x0 + x_inner, x0 + x_outer, y0 - y,  color16);
+        this->drawCircleYLine(area, x0 + y,  y0 - x_outer, y0 - x_inner, color16);
 
         y++;
 
@@ -244,30 +596,160 @@ void graphics::drawCircle2(point center, uint32_t radius, color color, uint32_t
     }
 }
 
+/**
+ * @private
+ * @brief Fill a rectangle grown by a circle, every row is filled once
+ * @param area Clip area to cut the rows down to
+ * @param left Left edge of the rectangle, the center for a plain circle
+ * @param top Top edge of the rectangle
+ * @param right Right edge of the rectangle, included in it
+ * @param bottom Bottom edge of the rectangle, included in it
+ * @param radius Radius of the circle
+ * @param color 16 bit color to fill with
+ * @note Uses the midpoint circle algorithm, so the edge matches drawCircle()
+ */
+void graphics::fillCircleRows(const clip_t& area, int32_t left, int32_t top, int32_t right, int32_t bottom, int32_t radius, uint16_t color)
+{
+    if (this->rejectClip(area, left - radius, top - radius, right + radius, bottom + radius))
+        return;
+
+    // https://en.wikipedia.org/wiki/Midpoint_circle_algorithm
+    int32_t x = radius;
+    int32_t y = 0;
+    int32_t error = 3 - 2 * x;
+
+    while (y <= x)
+    {
+        // the rows y away from the center are x wide, every y comes up once
+        this->fillMirroredRows(area, left, top, right, bottom, y, x, color);
+
+        // the rows x away are widest at the last y before x moves on, so they are filled then
+        if ((error > 0 || y + 1 > x) && x > y)
+            this->fillMirroredRows(area, left, top, right, bottom, x, y, color);
+
+        y++;
+
+        // Update the error
+        if (error > 0) 
+        {
+            x--;
+            error += 4 * (y - x) + 10;
+        }
+        else
+            error += 4 * y + 6;
+    }
+}
+
+/**
+ * @private
+ * @brief Fill a rectangle grown by an ellipse, every row is filled once
+ * @param area Clip area to cut the rows down to
+ * @param left Left edge of the rectangle, the center for a plain ellipse
+ * @param top Top edge of the rectangle
+ * @param right Right edge of the rectangle, included in it
+ * @param bottom Bottom edge of the rectangle, included in it
+ * @param radiusX Horizontal radius of the ellipse
+ * @param radiusY Vertical radius of the ellipse
+ * @param color 16 bit color to fill with
+ */
+void graphics::fillEllipseRows(const clip_t& area, int32_t left, int32_t top, int32_t right, int32_t bottom, int32_t radiusX, int32_t radiusY, uint16_t color)
+{
+    if (this->rejectClip(area, left - radiusX, top - radiusY, right + radiusX, bottom + radiusY))
+        return;
+
+    // a pixel is inside when (x / (radiusX + 1/2))^2 + (y / (radiusY + 1/2))^2 <= 1,
+    // everything is doubled to stay in integers
+    int64_t a = (int64_t)(2 * radiusX + 1) * (2 * radiusX + 1);
+    int64_t b = (int64_t)(2 * radiusY + 1) * (2 * radiusY + 1);
+    int64_t limit = a * b;
+
+    // the half width only shrinks going away from the center
+    int32_t x = radiusX;
+    for (int32_t y = 0; y <= radiusY; y++)
+    {
+        while (x > 0 && 4 * ((int64_t)x * x * b + (int64_t)y * y * a) > limit)
+            x--;
+
+        this->fillMirroredRows(area, left, top, right, bottom, y, x, color);
+    }
+}
+
+/**
+ * @private
+ * @brief Fill the rows above and below a rectangle at the same distance from it
+ * @param area Clip area to cut the rows down to
+ * @param left Left edge of the rectangle
+ * @param top Top edge of the rectangle
+ * @param right Right edge of the rectangle, included in it
+ * @param bottom Bottom edge of the rectangle, included in it
+ * @param offset Rows between the rectangle and the rows to fill, 0 fills the rectangle rows
+ * @param halfWidth Pixels the rows stick out on either side of the rectangle
+ * @param color 16 bit color to fill with
+ */
+void graphics::fillMirroredRows(const clip_t& area, int32_t left, int32_t top, int32_t right, int32_t bottom, int32_t offset, int32_t halfWidth, uint16_t color)
+{
+    int32_t x1 = imax(left - halfWidth, area.left);
+    int32_t x2 = imin(right + halfWidth, area.right - 1);
+    if (x2 < x1)
+        return;
+
+    if (offset == 0)
+    {
+        int32_t y1 = imax(top, area.top);
+        int32_t y2 = imin(bottom, area.bottom - 1);
+        if (y2 >= y1)
+            fillRect(this->frameBuffer + x1 + y1 * this->config->width, this->config->width, color, x2 - x1 + 1, y2 - y1 + 1);
+        return;
+    }
+
+    int32_t y = top - offset;
+    if (y >= area.top && y < area.bottom)
+        fillSpan(this->frameBuffer + x1 + y * this->config->width, color, x2 - x1 + 1);
+
+    y = bottom + offset;
+    if (y >= area.top && y < area.bottom)
+        fillSpan(this->frameBuffer + x1 + y * this->config->width, color, x2 - x1 + 1);
+}
+
 /**
  * @private
  * @brief Helper function to draw a horizontal line of a circle
+ * @param area Clip area to cut the line down to
  * @param x1 Start x coordinate
- * @param x2 End x coordinate
+ * @param x2 End x coordinate, included in the line
  * @param y Y coordinate
- * @param color color of the line
+ * @param color 16 bit color of the line
  */
-void graphics::drawCircleXLine(uint32_t x1, uint32_t x2, uint32_t y, color color)
+void graphics::drawCircleXLine(const clip_t& area, int32_t x1, int32_t x2, int32_t y, uint16_t color)
 {
-    while (x1 <= x2) this->setPixel(x1++, y, color.to16bit(this->config->inverseColors));
+    if (y < area.top || y >= area.bottom)
+        return;
+
+    x1 = imax(x1, area.left);
+    x2 = imin(x2, area.right - 1);
+    if (x2 >= x1)
+        fillSpan(this->frameBuffer + x1 + y * this->config->width, color, x2 - x1 + 1);
 }
 
 /**
  * @private
  * @brief Helper function to draw a vertical line of a circle
+ * @param area Clip area to cut the line down to
  * @param x X coordinate
  * @param y1 Start y coordinate
- * @param y2 End y coordinate
- * @param color color of the line
+ * @param y2 End y coordinate, included in the line
+ * @param color 16 bit color of the line
  */
-void graphics::drawCircleYLine(uint32_t x, uint32_t y1, uint32_t y2, color color)
+void graphics::drawCircleYLine(const clip_t& area, int32_t x, int32_t y1, int32_t y2, uint16_t color)
 {
-    while (y1 <= y2) this->setPixel(x, y1++, color.to16bit(this->config->inverseColors));
+    if (x < area.left || x >= area.right)
+        return;
+
+    y1 = imax(y1, area.top);
+    y2 = imin(y2, area.bottom - 1);
+    uint16_t* pixel = this->frameBuffer + x + y1 * this->config->width;
+    for (int32_t y = y1; y <= y2; y++, pixel += this->config->width)
+        *pixel = color;
 }
 
 /**
@@ -280,8 +762,13 @@ void graphics::drawCircleYLine(uint32_t x, uint32_t y1, uint32_t y2, color color
 */
 void graphics::drawArc(point center, uint32_t radius, uint32_t start_angle, uint32_t end_angle, color color)
 {
-    uint32_t imageWidth = config->width;
-    uint32_t imageHeight = config->height;
+    PROFILE_SCOPE("drawArc", (710 * radius / 113) * iabs((int32_t)end_angle - (int32_t)start_angle) / 360);
+
+    this->markDamage(center.x - (int32_t)radius - 1, center.y - (int32_t)radius - 1, center.x + (int32_t)radius + 1, center.y + (int32_t)radius + 1);
+
+    clip_t area = this->getClipArea();
+    if (this->rejectClip(area, center.x - (int32_t)radius - 1, center.y - (int32_t)radius - 1, center.x + (int32_t)radius + 1, center.y + (int32_t)radius + 1))
+        return;
 
 	// Swap angles if start_angle is greater than end_angle
     if (end_angle < start_angle) 
@@ -303,49 +790,215 @@ void graphics::drawArc(point center, uint32_t radius, uint32_t start_angle, uint
 		pcircle(radius, angle, center.x, center.y, &x, &y);
 
 		// avoid overflowing the buffer
-        if (x >= 0 && x < imageWidth && y >= 0 && y < imageHeight)
-            this->frameBuffer[x + y * imageWidth] = color16bit;
+        this->setPixel(x, y, color16bit);
     }
 }
 
 /**
- * @brief Draw two arcs and fill the gap between them
+ * @brief Fill the part of a ring between two angles
  * @param center Center point
  * @param innerRadius Radius for the inner most arc
  * @param outerRadius Radius for the outer most arc
  * @param startAngle Angle in degrees for both arcs
- * @param endAngle Angle in degrees for both arcs
+ * @param endAngle Angle in degrees for both arcs, 360 degrees past the start fills the whole ring
  * @color color to draw the arc in
+ * @note The start angle is included and the end angle is not, so arcs that share an angle
+ *       neither overlap nor leave a gap between them
  */
 void graphics::drawFilledDualArc(point center, uint32_t innerRadius, uint32_t outerRadius, uint32_t startAngle, uint32_t endAngle, color color)
 {
-    // Transform angles from [-180, 180] to [0, 360)
-    startAngle = inorm(startAngle);
-    endAngle = inorm(endAngle);
-    startAngle *= 10;
-    endAngle *= 10;
-    
-    if (endAngle < startAngle) endAngle += 3600;
+    PROFILE_SCOPE("drawFilledDualArc", (profileCircleArea(outerRadius) - profileCircleArea(innerRadius)) * inorm((int32_t)endAngle - (int32_t)startAngle) / 360);
 
-    uint16_t color16 = color.to16bit(this->config->inverseColors);
+    int32_t outer = (int32_t)outerRadius;
+    int32_t inner = (int32_t)innerRadius;
+    if (inner > outer)
+        return;
+
+    sector_t sector;
+    if (!sectorSetup(&sector, (int32_t)startAngle, (int32_t)endAngle))
+        return;
 
-    for (int32_t angleLUT = startAngle; angleLUT <= endAngle; angleLUT++)
+    uint16_t color16 = color.to16bit(this->config->inverseColors);
+    int32_t reach = outer + 1;
+    this->markDamage(center.x - reach, center.y - reach, center.x + reach, center.y + reach);
+
+    clip_t area = this->getClipArea();
+    if (this->rejectClip(area, center.x - outer, center.y - outer, center.x + outer, center.y + outer))
+        return;
+
+    // a pixel is in the ring when inner - 1/2 <= distance <= outer + 1/2, doubled to stay in integers
+    int64_t outerLimit = (int64_t)(2 * outer + 1) * (2 * outer + 1);
+    int64_t innerLimit = (int64_t)(2 * inner - 1) * (2 * inner - 1);
+
+    // half widths of the ring and of the hole in it, both only shrink going away from the center
+    int32_t x = outer;
+    int32_t hole = inner - 1;
+    int32_t spans[4];
+    for (int32_t y = 0; y <= outer; y++)
     {
-        int32_t cosValue = icosd(angleLUT);
-        int32_t sinValue = isind(angleLUT);
+        while (x > 0 && 4 * ((int64_t)x * x + (int64_t)y * y) > outerLimit)
+            x--;
+        while (hole >= 0 && 4 * ((int64_t)hole * hole + (int64_t)y * y) >= innerLimit)
+            hole--;
 
-        for (int32_t radius = innerRadius; radius <= outerRadius; radius++)
+        // the row above the center, then the one below it
+        for (int32_t dy = -y; dy <= y; dy += 2 * y)
         {
-            int32_t x = cosValue * radius;
-            x >>= COS_MULTIPLIER_BITS;
-            x += center.x;
+            int32_t row = center.y + dy;
+            if (row >= area.top && row < area.bottom)
+            {
+                size_t count = sectorSpans(sector, dy, spans);
+                for (size_t i = 0; i < count; i++)
+                {
+                    if (hole < 0)
+                    {
+                        this->drawCircleXLine(area, center.x + imax(spans[2 * i], -x), center.x + imin(spans[2 * i + 1], x), row, color16);
+                        continue;
+                    }
+
+                    this->drawCircleXLine(area, center.x + imax(spans[2 * i], -x), center.x + imin(spans[2 * i + 1], -hole - 1), row, color16);
+                    this->drawCircleXLine(area, center.x + imax(spans[2 * i], hole + 1), center.x + imin(spans[2 * i + 1], x), row, color16);
+                }
+            }
+
+            if (y == 0)
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Draw a circle on the display with anti-aliasing
+ * @param center Center point
+ * @param radius Radius of the circle
+ * @param color color to draw in
+ * @param thickness Thickness of the circle, centered on the radius
+ */
+void graphics::drawCircleAntiAliased(point center, uint32_t radius, color color, uint32_t thickness)
+{
+    PROFILE_SCOPE("drawCircleAntiAliased", (710 * radius / 113) * imax(thickness, 1));
+
+    int32_t width = imax(thickness, 1);
+    this->fillRingAntiAliased(center, 2 * (int32_t)radius + width, 2 * (int32_t)radius - width, 0, 360, color.to16bit(this->config->inverseColors));
+}
+
+/**
+ * @brief Draw a filled circle on the display with anti-aliasing
+ * @param center Center point
+ * @param radius Radius of the circle
+ * @param color color to draw in
+ */
+void graphics::drawFilledCircleAntiAliased(point center, uint32_t radius, color color)
+{
+    PROFILE_SCOPE("drawFilledCircleAntiAliased", profileCircleArea(radius));
+
+    this->fillRingAntiAliased(center, 2 * (int32_t)radius + 1, 0, 0, 360, color.to16bit(this->config->inverseColors));
+}
+
+/**
+ * @brief Draw an arc on the display with anti-aliasing
+ * @param center Center point
+ * @param radius Radius of the arc
+ * @param startAngle Angle in degrees the arc starts at
+ * @param endAngle Angle in degrees the arc runs clockwise to
+ * @param color color to draw in
+ * @param thickness Thickness of the arc, centered on the radius
+ */
+void graphics::drawArcAntiAliased(point center, uint32_t radius, uint32_t startAngle, uint32_t endAngle, color color, uint32_t thickness)
+{
+    PROFILE_SCOPE("drawArcAntiAliased", (710 * radius / 113) * imax(thickness, 1) * inorm((int32_t)endAngle - (int32_t)startAngle) / 360);
+
+    int32_t width = imax(thickness, 1);
+    this->fillRingAntiAliased(center, 2 * (int32_t)radius + width, 2 * (int32_t)radius - width, startAngle, endAngle, color.to16bit(this->config->inverseColors));
+}
+
+/**
+ * @brief Fill the part of a ring between two angles with anti-aliasing
+ * @param center Center point
+ * @param innerRadius Radius for the inner most arc
+ * @param outerRadius Radius for the outer most arc
+ * @param startAngle Angle in degrees for both arcs
+ * @param endAngle Angle in degrees for both arcs, 360 degrees past the start fills the whole ring
+ * @param color color to draw the arc in
+ * @note Covers the same pixels as drawFilledDualArc(), with the edges blended
+ */
+void graphics::drawFilledDualArcAntiAliased(point center, uint32_t innerRadius, uint32_t outerRadius, uint32_t startAngle, uint32_t endAngle, color color)
+{
+    PROFILE_SCOPE("drawFilledDualArcAntiAliased", (profileCircleArea(outerRadius) - profileCircleArea(innerRadius)) * inorm((int32_t)endAngle - (int32_t)startAngle) / 360);
 
-            int32_t y = sinValue * radius;
-            y >>= SIN_MULTIPLIER_BITS;
-            y += center.y;
+    if (innerRadius > outerRadius)
+        return;
+
+    this->fillRingAntiAliased(center, 2 * (int32_t)outerRadius + 1, 2 * (int32_t)innerRadius - 1, startAngle, endAngle, color.to16bit(this->config->inverseColors));
+}
+
+/**
+ * @private
+ * @brief Fill a ring, or the part of it between two angles, with anti-aliased edges
+ * @param center Center point
+ * @param outerEdge Doubled radius of the outer edge
+ * @param innerEdge Doubled radius of the inner edge, 0 or less for a disc
+ * @param startAngle Angle in degrees the ring starts at
+ * @param endAngle Angle in degrees the ring ends at, 360 degrees past the start for a whole ring
+ * @param color 16 bit color to fill with
+ * @note Only the pixels on the edges are blended, the rest of every row is filled as a span
+ */
+void graphics::fillRingAntiAliased(point center, int32_t outerEdge, int32_t innerEdge, int32_t startAngle, int32_t endAngle, uint16_t color)
+{
+    ring_t ring;
+    if (outerEdge <= 0 || innerEdge >= outerEdge || !sectorSetup(&ring.sector, startAngle, endAngle))
+        return;
+
+    // the outer edge touches the pixels less than half a pixel outside of it
+    int32_t reach = outerEdge / 2 + 1;
+    this->markDamage(center.x - reach, center.y - reach, center.x + reach, center.y + reach);
+
+    clip_t area = this->getClipArea();
+    if (this->rejectClip(area, center.x - reach, center.y - reach, center.x + reach, center.y + reach))
+        return;
+
+    ring.outer = outerEdge;
+    ring.inner = innerEdge;
+    ring.x = center.x;
+    ring.left = area.left - center.x;
+    ring.right = area.right - 1 - center.x;
+    ring.color = color;
+
+    // an edge covers all of a pixel within half a pixel inside of it and part of one
+    // within half a pixel outside of it, everything is doubled to stay in integers
+    int64_t edgeLimit = (int64_t)(outerEdge + 1) * (outerEdge + 1);
+    int64_t solidLimit = (int64_t)(outerEdge - 1) * (outerEdge - 1);
+    int64_t holeEdgeLimit = innerEdge > 0 ? (int64_t)(innerEdge + 1) * (innerEdge + 1) : 0;
+    int64_t holeLimit = innerEdge > 0 ? (int64_t)(innerEdge - 1) * (innerEdge - 1) : -1;
+
+    // the last column of every kind only moves towards the center going away from it
+    int32_t edge = reach;
+    int32_t solid = reach;
+    int32_t holeEdge = reach;
+    int32_t hole = reach;
+    for (int32_t y = 0; ; y++)
+    {
+        int64_t rowDistance = 4 * (int64_t)y * y;
+        while (edge >= 0 && 4 * (int64_t)edge * edge + rowDistance >= edgeLimit)
+            edge--;
+        while (solid >= 0 && 4 * (int64_t)solid * solid + rowDistance > solidLimit)
+            solid--;
+        while (holeEdge >= 0 && 4 * (int64_t)holeEdge * holeEdge + rowDistance >= holeEdgeLimit)
+            holeEdge--;
+        while (hole >= 0 && 4 * (int64_t)hole * hole + rowDistance > holeLimit)
+            hole--;
+        if (edge < 0)
+            break;
+
+        // the row above the center, then the one below it
+        for (int32_t dy = -y; dy <= y; dy += 2 * y)
+        {
+            int32_t row = center.y + dy;
+            if (row >= area.top && row < area.bottom)
+                ringRow(this->frameBuffer + row * this->config->width, ring, dy, hole, holeEdge, solid, edge);
 
-            if (x >= 0 && x < config->width && y >= 0 && y < config->height)
-                this->frameBuffer[x + y * config->width] = color16;
+            if (y == 0)
+                break;
         }
     }
 }
\ No newline at end of file
@@ -5,14 +5,25 @@
 #define ERR_DOWN_L 3
 #define ERR_DOWN_R 1
 
+// error carried into the current and the next row, three channels per pixel,
+// too big for the stack of a core so it is shared by every graphics object
+static int16_t errorBuffer[2 * 3 * GRAPHICS_DITHER_WIDTH];
+
 /**
  * @brief Add a Bayer filter to the display
+ * @note Only the rows in the band are filtered
  */
 void graphics::addBayerFilter(void)
 {
+    PROFILE_SCOPE("addBayerFilter", this->config->width * this->config->height);
+
+    this->markDamage(0, 0, this->config->width - 1, this->config->height - 1);
+
     // loop through each and every pixel
-    uint16_t* ptr = this->frameBuffer;
-    for (size_t y = 0; y < this->config->height; y++)
+    size_t firstY = imax(this->bandTop, 0);
+    size_t lastY = imin(this->bandBottom, (int32_t)this->config->height);
+    uint16_t* ptr = this->frameBuffer + firstY * this->config->width;
+    for (size_t y = firstY; y < lastY; y++)
     {
         for (size_t x = 0; x < this->config->width; x++)
         {
@@ -37,14 +48,26 @@ void graphics::addBayerFilter(void)
 
 /**
  * @brief Add a Floyd-Steinberg dithering filter to the display
+ * @note Only the rows in the band are filtered
+ * @note Only the first GRAPHICS_DITHER_WIDTH columns are filtered, it is not safe to call from both cores at once
  */
 void graphics::addFloydSteinbergDithering(void)
 {
-    int16_t error_buffer[this->config->width * 3] = {0};
+    PROFILE_SCOPE("addFloydSteinbergDithering", this->config->width * this->config->height);
+
+    this->markDamage(0, 0, this->config->width - 1, this->config->height - 1);
+
+    int columns = imin(width, GRAPHICS_DITHER_WIDTH);
+    int16_t* current = errorBuffer;
+    int16_t* next = errorBuffer + columns * 3;
+    for (int e = 0; e < columns * 6; e++)
+        errorBuffer[e] = 0;
     
-    for (int y = 0; y < height - 1; y++) {
-        for (int x = 1; x < width - 1; x++) {
+    int lastY = imin(this->bandBottom, (int32_t)height - 1);
+    for (int y = imax(this->bandTop, 0); y < lastY; y++) {
+        for (int x = 1; x < columns - 1; x++) {
             int i = y * width + x;
+            int e = x * 3;
 
             // Extract RGB565 components
             uint16_t pixel = this->frameBuffer[i];
@@ -53,9 +76,9 @@ void graphics::addFloydSteinbergDithering(void)
             uint8_t b = pixel & 0x1F;
 
             // Apply stored error
-            r = (r + (error_buffer[i * 3]   >> 4)) & 0x1F;
-            g = (g + (error_buffer[i * 3+1] >> 4)) & 0x3F;
-            b = (b + (error_buffer[i * 3+2] >> 4)) & 0x1F;
+            r = (r + (current[e]   >> 4)) & 0x1F;
+            g = (g + (current[e+1] >> 4)) & 0x3F;
+            b = (b + (current[e+2] >> 4)) & 0x1F;
 
             // Quantize to RGB565
             uint16_t new_pixel = (r << 11) | (g << 5) | b;
@@ -67,30 +90,42 @@ void graphics::addFloydSteinbergDithering(void)
             int16_t err_b = (b << 3) - (new_pixel & 0x1F) * 8;
 
             // Diffuse error (scaled for integer math)
-            error_buffer[(i + 1) * 3]   += err_r * ERR_RIGHT;
-            error_buffer[(i + 1) * 3+1] += err_g * ERR_RIGHT;
-            error_buffer[(i + 1) * 3+2] += err_b * ERR_RIGHT;
+            current[e+3] += err_r * ERR_RIGHT;
+            current[e+4] += err_g * ERR_RIGHT;
+            current[e+5] += err_b * ERR_RIGHT;
 
-            error_buffer[(i + width - 1) * 3]   += err_r * ERR_DOWN_L;
-            error_buffer[(i + width - 1) * 3+1] += err_g * ERR_DOWN_L;
-            error_buffer[(i + width - 1) * 3+2] += err_b * ERR_DOWN_L;
+            next[e-3] += err_r * ERR_DOWN_L;
+            next[e-2] += err_g * ERR_DOWN_L;
+            next[e-1] += err_b * ERR_DOWN_L;
 
-            error_buffer[(i + width) * 3]   += err_r * ERR_DOWN;
-            error_buffer[(i + width) * 3+1] += err_g * ERR_DOWN;
-            error_buffer[(i + width) * 3+2] += err_b * ERR_DOWN;
+            next[e]   += err_r * ERR_DOWN;
+            next[e+1] += err_g * ERR_DOWN;
+            next[e+2] += err_b * ERR_DOWN;
 
-            error_buffer[(i + width + 1) * 3]   += err_r * ERR_DOWN_R;
-            error_buffer[(i + width + 1) * 3+1] += err_g * ERR_DOWN_R;
-            error_buffer[(i + width + 1) * 3+2] += err_b * ERR_DOWN_R;
+            next[e+3] += err_r * ERR_DOWN_R;
+            next[e+4] += err_g * ERR_DOWN_R;
+            next[e+5] += err_b * ERR_DOWN_R;
         }
+
+        // move on to the next row and clear the one after it
+        int16_t* done = current;
+        current = next;
+        next = done;
+        for (int e = 0; e < columns * 3; e++)
+            next[e] = 0;
     }
 }
 
 /**
  * @brief Apply a simple blur to the display to combat pixelation
+ * @note Only the rows in the band are filtered, the edge rows of a band are left alone
 */
 void graphics::addAntiAliasingFilter(void)
 {
+    PROFILE_SCOPE("addAntiAliasingFilter", this->config->width * this->config->height);
+
+    this->markDamage(0, 0, this->config->width - 1, this->config->height - 1);
+
     // Helper function to get the color difference between two pixels
     #define COLOR_DIFF(pixel1, pixel2) ( \
         iabs(((pixel1 & 0xF800) >> 8) - ((pixel2 & 0xF800) >> 8)) + \
@@ -98,8 +133,9 @@ void graphics::addAntiAliasingFilter(void)
         iabs(((pixel1 & 0x001F) << 3) - ((pixel2 & 0x001F) << 3)) \
     )
 
-    // Loop through all the pixels in the framebuffer
-    for (int32_t y = 1; y < (this->config->height - 1); y++)
+    // Loop through all the pixels in the framebuffer, neighbours have to be in the band as well
+    int32_t lastY = imin(this->bandBottom, (int32_t)this->config->height) - 1;
+    for (int32_t y = imax(this->bandTop, 0) + 1; y < lastY; y++)
     {
         for (int32_t x = 1; x < (this->config->width - 1); x++)
         {
@@ -145,13 +181,23 @@ void graphics::addBlur(void)
 
 /**
  * @brief Apply a blur to a specific area of the display
- * @param area Area to apply the blur to
+ * @param area Area to apply the blur to, the right and bottom edges are not part of it
+ * @note Only the rows in the band are filtered, the edge rows of a band and the edges of the display are left alone
  */
 void graphics::addBlur(rect area)
 {
-    for (int32_t y = 1; y < this->config->height - 1; y++) 
+    PROFILE_SCOPE("addBlur", area.width() * area.height());
+
+    this->markDamage(area.left(), area.top(), area.right() - 1, area.bottom() - 1);
+
+    // every pixel needs its neighbours, so the outer rows and columns are skipped
+    int32_t firstX = imax(area.left(), 1);
+    int32_t lastX = imin(area.right(), (int32_t)this->config->width - 1);
+    int32_t firstY = imax(area.top(), imax(this->bandTop, 0) + 1);
+    int32_t lastY = imin(area.bottom(), imin(this->bandBottom, (int32_t)this->config->height) - 1);
+    for (int32_t y = firstY; y < lastY; y++) 
     {
-        for (int32_t x = 1; x < this->config->width - 1; x++) 
+        for (int32_t x = firstX; x < lastX; x++) 
         {
             int32_t i = x + y * this->config->width;
 
@@ -17,12 +17,34 @@ int32_t iabs(int32_t x)
 
 int32_t isqrt(int32_t x)
 {
-	int32_t result = 0;
-	
-	while ((result + 1) * (result + 1) <= x)
-		result++;
-	
-	return result;
+	if (x <= 0)
+		return 0;
+
+	return (int32_t)isqrt64((uint64_t)x);
+}
+
+uint32_t isqrt64(uint64_t x)
+{
+	// work out the result one bit at a time, from the highest bit down
+	uint64_t result = 0;
+	uint64_t bit = 1ULL << 62;
+
+	while (bit > x)
+		bit >>= 2;
+
+	while (bit != 0)
+	{
+		if (x >= result + bit)
+		{
+			x -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else
+			result >>= 1;
+		bit >>= 2;
+	}
+
+	return (uint32_t)result;
 }
 
 int32_t ipow(int32_t x, int32_t y)
@@ -80,4 +102,18 @@ int32_t clamp(int32_t x, int32_t min, int32_t max)
 	if (x > max) x = max;
 	// return clamped value
 	return x;
+}
+
+// coverage of a pixel by a circle with a doubled radius of edge, distance is 4 times the squared
+// distance to the center, the square root is replaced by the first two terms of its series
+int32_t icoverage(int32_t edge, int64_t distance)
+{
+	int32_t half = COVERAGE_MAX / 2;
+	int32_t u = (int32_t)(((int64_t)edge * edge - distance) * (COVERAGE_MAX / 4) / edge);
+	if (u >= half)
+		return COVERAGE_MAX;
+	if (u <= -3 * half)
+		return 0;
+
+	return clamp(half + u + u * u / (COVERAGE_MAX * edge), 0, COVERAGE_MAX);
 }
\ No newline at end of file
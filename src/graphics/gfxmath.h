@@ -13,6 +13,7 @@ extern int32_t imin(int32_t x, int32_t y);
 extern int32_t imax(int32_t x, int32_t y);
 extern int32_t iabs(int32_t x);
 extern int32_t isqrt(int32_t x);
+extern uint32_t isqrt64(uint64_t x);
 extern int32_t ipow(int32_t x, int32_t y);
 extern int32_t ifactorial(int32_t x);
 
@@ -21,6 +22,11 @@ extern void pcircle(int32_t radius, int32_t angle, int32_t offsetX, int32_t offs
 extern int32_t lerp(int32_t v0, int32_t v1, int32_t t);
 extern int32_t clamp(int32_t x, int32_t min, int32_t max);
 
+// Coverage of a pixel that lies fully inside an anti-aliased shape
+#define COVERAGE_MAX 256
+
+extern int32_t icoverage(int32_t edge, int64_t distance);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "graphics.hpp"
+#include <string.h>
 
 /**
  * @brief Construct a new graphics object
@@ -13,26 +14,134 @@ graphics::graphics(uint16_t* frameBuffer, display_config_t* config)
     this->height = config->height;
 }
 
+/**
+ * @brief Point the object at a whole frame buffer
+ * @param frameBuffer Buffer of width * height pixels
+ * @note Removes the band set by setBand()
+*/
+void graphics::setFrameBuffer(uint16_t* frameBuffer)
+{
+    this->frameBuffer = frameBuffer;
+    this->bandTop = 0;
+    this->bandBottom = INT32_MAX;
+    this->updateClip();
+}
+
+/**
+ * @brief Draw into a strip of rows instead of a whole frame buffer
+ * @param buffer Buffer of width * rows pixels
+ * @param top First display row held by the buffer
+ * @param rows Number of rows in the buffer
+ * @note Everything outside the band is clipped, coordinates stay display coordinates
+*/
+void graphics::setBand(uint16_t* buffer, int32_t top, uint32_t rows)
+{
+    // offset the buffer so display coordinates index straight into the strip
+    this->frameBuffer = buffer - top * (int32_t)this->config->width;
+    this->bandTop = top;
+    this->bandBottom = top + (int32_t)rows;
+    this->updateClip();
+}
+
+/**
+ * @brief Limit drawing to an area until popClip() is called
+ * @param area Area that can be drawn to, the right and bottom edges are not part of it
+ * @return bool False if GRAPHICS_CLIP_DEPTH rects are pushed already, nothing is pushed then
+ * @note The area is cut down to the area pushed before it, the filters are not clipped
+*/
+bool graphics::pushClip(rect area)
+{
+    return this->pushClip(point((int32_t)area.left(), (int32_t)area.top()), point((int32_t)area.right(), (int32_t)area.bottom()));
+}
+
+/**
+ * @brief Limit drawing to an area until popClip() is called
+ * @param start Upper left corner of the area
+ * @param end Lower right corner of the area, not part of it
+ * @return bool False if GRAPHICS_CLIP_DEPTH rects are pushed already, nothing is pushed then
+ * @note The area is cut down to the area pushed before it, the filters are not clipped
+*/
+bool graphics::pushClip(point start, point end)
+{
+    if (this->clipDepth >= GRAPHICS_CLIP_DEPTH)
+        return false;
+
+    clip_t area = { start.x, start.y, end.x, end.y };
+    if (this->clipDepth > 0)
+    {
+        const clip_t& below = this->clipStack[this->clipDepth - 1];
+        area.left = imax(area.left, below.left);
+        area.top = imax(area.top, below.top);
+        area.right = imin(area.right, below.right);
+        area.bottom = imin(area.bottom, below.bottom);
+    }
+
+    this->clipStack[this->clipDepth++] = area;
+    this->updateClip();
+    return true;
+}
+
+/**
+ * @brief Go back to the area that could be drawn to before the last pushClip()
+*/
+void graphics::popClip(void)
+{
+    if (this->clipDepth == 0)
+        return;
+
+    this->clipDepth--;
+    this->updateClip();
+}
+
+/**
+ * @brief Get the area that can be drawn to
+ * @return rect The pushed clip rects and the band cut down to the display, empty if nothing can be drawn
+*/
+rect graphics::getClip(void)
+{
+    clip_t area = this->getClipArea();
+    if (area.left >= area.right || area.top >= area.bottom)
+        return rect();
+
+    return rect(area.left, area.top, area.right, area.bottom);
+}
+
+/**
+ * @private
+ * @brief Combine the band and the top clip rect into the area the primitives clip against
+*/
+void graphics::updateClip(void)
+{
+    clip_t area = { 0, 0, INT32_MAX, INT32_MAX };
+    if (this->clipDepth > 0)
+        area = this->clipStack[this->clipDepth - 1];
+
+    area.left = imax(area.left, 0);
+    area.top = imax(area.top, imax(this->bandTop, 0));
+    area.bottom = imin(area.bottom, this->bandBottom);
+    this->clip = area;
+}
+
 /**
  * @brief Fill the display with a color
  * @param color color to fill with
 */
 void graphics::fill(color color)
 {
-    // convert color to 16 bit
-    uint16_t color16 = color.to16bit(this->config->inverseColors);
-	uint32_t totalPixels = this->config->width * this->config->height;
-    // fill the frame buffer
-    for (int32_t i = 0; i < totalPixels; i++)
-        this->frameBuffer[i] = color16;
+    this->fill(color.to16bit(false));
 }
 
 /**
  * @brief Fill the display with a color
  * @param color color to fill with
+ * @note Only the clip area is filled
 */
 void graphics::fill(uint16_t color)
 {
+    PROFILE_SCOPE("fill", this->config->width * this->config->height);
+
+    this->markDamage(0, 0, this->config->width - 1, this->config->height - 1);
+
 	uint16_t color16 = color;
 
 	if (this->config->inverseColors)
@@ -43,10 +152,72 @@ void graphics::fill(uint16_t color)
 		color16 = (color16 >> 8) | (color16 << 8);
 	}
 
-	uint32_t totalPixels = this->config->width * this->config->height;
-    // fill the frame buffer
-    for (int32_t i = 0; i < totalPixels; i++)
-        this->frameBuffer[i] = color16;
+	// fill the part of the frame buffer that is in the clip area
+	clip_t area = this->getClipArea();
+	if (area.left < area.right && area.top < area.bottom)
+		fillRect(this->frameBuffer + area.left + area.top * this->config->width, this->config->width, color16, area.right - area.left, area.bottom - area.top);
+}
+
+/**
+ * @brief Blend a color over the whole display
+ * @param color color to blend with
+ * @param alpha Alpha value of the color, 0 is transparent, 255 is opaque
+ * @note Only the clip area is blended
+*/
+void graphics::fill(color color, uint8_t alpha)
+{
+    PROFILE_SCOPE("fill alpha", this->config->width * this->config->height);
+
+    this->markDamage(0, 0, this->config->width - 1, this->config->height - 1);
+
+    uint16_t color16 = color.to16bit(this->config->inverseColors);
+
+    // blend the part of the frame buffer that is in the clip area
+    clip_t area = this->getClipArea();
+    if (area.left < area.right && area.top < area.bottom)
+        blendRect(this->frameBuffer + area.left + area.top * this->config->width, this->config->width, color16, spanAlpha(alpha), area.right - area.left, area.bottom - area.top);
+}
+
+/**
+ * @brief Move the pixels of a block on the display
+ * @param start Upper left corner of the block
+ * @param end Lower right corner of the block, not part of it
+ * @param dx Number of pixels to move right, negative to move left
+ * @param dy Number of pixels to move down, negative to move up
+ * @note Pixels moved out of the block are dropped and the ones uncovered keep
+ * their old color, only the part of the block in the clip area takes part
+*/
+void graphics::scroll(point start, point end, int32_t dx, int32_t dy)
+{
+    PROFILE_SCOPE("scroll", (end.x - start.x) * (end.y - start.y));
+
+    this->markDamage(start.x, start.y, end.x - 1, end.y - 1);
+
+    clip_t area = this->getClipArea();
+    int32_t left = imax(start.x, area.left);
+    int32_t right = imin(end.x, area.right);
+    int32_t top = imax(start.y, area.top);
+    int32_t bottom = imin(end.y, area.bottom);
+
+    int32_t columns = right - left - iabs(dx);
+    int32_t rows = bottom - top - iabs(dy);
+    if (columns <= 0 || rows <= 0)
+        return;
+
+    // walk the rows against the direction of the move so none is overwritten before it is read
+    int32_t width = this->config->width;
+    int32_t sourceX = dx > 0 ? left : left - dx;
+    int32_t sourceY = dy > 0 ? bottom - 1 - dy : top - dy;
+    int32_t stride = dy > 0 ? -width : width;
+    uint16_t* source = this->frameBuffer + sourceX + sourceY * width;
+    uint16_t* destination = source + dx + dy * width;
+
+    for (int32_t y = 0; y < rows; y++)
+    {
+        memmove(destination, source, columns * sizeof(uint16_t));
+        source += stride;
+        destination += stride;
+    }
 }
 
 /**
@@ -54,6 +225,10 @@ void graphics::fill(uint16_t color)
 */
 void graphics::testPattern(void)
 {
+    PROFILE_SCOPE("testPattern", this->config->width * this->config->height);
+
+    this->markDamage(0, 0, this->config->width - 1, this->config->height - 1);
+
 	color top_row[] = {
 		colors::argent, colors::acidGreen, colors::turquoiseSurf,
 		colors::islamicGreen, colors::deepMagenta, colors::ueRed,
@@ -125,12 +300,6 @@ void graphics::testPattern(void)
 	this->drawFilledRectangle(start, end, bottom_row[4]);
 }
 
-//   rrrrrggggggbbbbb
-#define RB_MASK      63519  // 0b1111100000011111        --> hex :F81F
-#define G_MASK        2016  // 0b0000011111100000        --> hex :07E0
-#define RB_MUL_MASK 2032608 // 0b111110000001111100000   --> hex :1F03E0
-#define G_MUL_MASK   64512  // 0b000001111110000000000   --> hex :FC00
-
 /**
  * @private
  * @brief Helper function to blend the pixel color with the background for anti-aliasing
@@ -140,25 +309,11 @@ void graphics::testPattern(void)
  * @param alpha Alpha value of the pixel to blend, 0 is transparent, 255 is opaque
  * @note Sets the pixel at the given index to the blended color
  */
-void graphics::setPixelBlend(uint32_t x, uint32_t y, uint16_t color, uint8_t alpha)
+void graphics::setPixelBlend(int32_t x, int32_t y, uint16_t color, uint8_t alpha)
 {
-    // Taken from this stackoverflow answer https://stackoverflow.com/questions/72456587/implement-a-function-that-blends-two-colors-encoded-with-rgb565-using-alpha-blen
+    if (!this->inClip(x, y))
+        return;
 
-    // Get the buffer index
     int32_t index = x + y * this->config->width;
-
-    // Reduce the alpha from [0,255] to [0,31] 
-    alpha = alpha >> 0x3;
-    // Create the inverse alpha value and call it beta
-    uint8_t beta = 0x20 - alpha;
-
-    // Get the background color
-    uint16_t background = this->frameBuffer[index];
-
-    // Apply the alpha blending formula
-    uint16_t result = (uint16_t)((((alpha * (uint32_t)(color & RB_MASK) + beta * (uint32_t)(background & RB_MASK)) & RB_MUL_MASK)
-        | ((alpha * (color & G_MASK) + beta * (background & G_MASK)) & G_MUL_MASK)) >> 0x5);
-
-    // Apply the blended color to the framebuffer
-    this->frameBuffer[index] = result;
+    this->frameBuffer[index] = blendPixel(this->frameBuffer[index], color, spanAlpha(alpha));
 }
\ No newline at end of file
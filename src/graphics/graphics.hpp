@@ -4,8 +4,59 @@
 #include "display_struct.h"
 #include "shapes.hpp"
 #include "gfxmath.h"
+#include "span.h"
+#include "damage.hpp"
+#include "profiler.hpp"
 #include <stdint.h>
 
+// Number of clip rects that can be pushed on top of each other
+#ifndef GRAPHICS_CLIP_DEPTH
+#define GRAPHICS_CLIP_DEPTH 8
+#endif
+
+// Edges a filled polygon keeps on the stack, larger polygons are filled in bands of rows
+#ifndef GRAPHICS_POLYGON_EDGES
+#define GRAPHICS_POLYGON_EDGES 32
+#endif
+
+// Widest row Floyd-Steinberg dithering keeps the error of, columns past it are left alone
+#ifndef GRAPHICS_DITHER_WIDTH
+#define GRAPHICS_DITHER_WIDTH 320
+#endif
+
+// Longest a miter join gets, in half line thicknesses from the corner, before it is cut off as a bevel
+#ifndef GRAPHICS_MITER_LIMIT
+#define GRAPHICS_MITER_LIMIT 4
+#endif
+
+typedef enum
+{
+    CapButt,        // ends flat at the end point
+    CapSquare,      // ends flat half the thickness past the end point
+    CapRound,       // ends in a half circle around the end point
+} line_cap_t;
+
+typedef enum
+{
+    JoinMiter,      // the outer edges go on until they meet, cut off as a bevel past GRAPHICS_MITER_LIMIT
+    JoinBevel,      // the outer corner is cut off straight
+    JoinRound,      // the outer corner is rounded around the point
+} line_join_t;
+
+typedef enum
+{
+    FillNonZero,    // inside where the outline winds around the point
+    FillEvenOdd,    // inside where a ray from the point crosses the outline an odd number of times
+} fill_rule_t;
+
+typedef struct
+{
+    int32_t left;
+    int32_t top;
+    int32_t right;      // first column outside the area
+    int32_t bottom;     // first row outside the area
+} clip_t;
+
 class graphics
 {
 public:
@@ -13,12 +64,15 @@ public:
 
     void fill(color color);
     void fill(uint16_t color);
+    void fill(color color, uint8_t alpha);
 
     void testPattern(void);
+    void scroll(point start, point end, int32_t dx, int32_t dy);
 
     void drawLine(point start, point end, color color = colors::white);
     void drawLineAntiAliased(point start, point end, color color = colors::white);
-    void drawLineThickAntiAliased(point start, point end, uint32_t thickness, color color = colors::white);
+    void drawLineThickAntiAliased(point start, point end, uint32_t thickness, color color = colors::white, line_cap_t cap = CapButt);
+    void drawPolyline(point* points, size_t numberOfPoints, uint32_t thickness, color color = colors::white, line_cap_t cap = CapButt, line_join_t join = JoinMiter);
 
 	void drawTriangle(point p1, point p2, point p3, color color = colors::white);
 	void drawFilledTriangle(point p1, point p2, point p3, color color = colors::white);
@@ -27,9 +81,11 @@ public:
     void drawRectangle(rect rect, color color = colors::white);
     void drawRectangle(point center, uint32_t width, uint32_t height, color color = colors::white);
     void drawFilledRectangle(point start, point end, color color = colors::white);
+    void drawTranslucentRectangle(point start, point end, color color, uint8_t alpha);
+    void drawFilledRoundedRectangle(point start, point end, uint32_t radius, color color = colors::white);
 
     void drawPolygon(point* points, size_t numberOfPoints, color color = colors::white);
-    void drawFilledPolygon(point* points, size_t numberOfPoints, color color = colors::white);
+    void drawFilledPolygon(point* points, size_t numberOfPoints, color color = colors::white, fill_rule_t rule = FillNonZero);
 
     void drawCircle(circle c, color color = colors::white, uint32_t thickness = 1);
     void drawCircle(point center, uint32_t radius, color color = colors::white, uint32_t thickness = 1);
@@ -37,9 +93,14 @@ public:
     void drawFilledCircle(point center, uint32_t radius, color color = colors::white);
     void drawFilledCircleWithStroke(circle c, color fillColor, color strokeColor, uint32_t strokeThickness);
     void drawFilledCircleWithStroke(point center, uint32_t radius, color fillColor, color strokeColor, uint32_t strokeThickness);
+    void drawFilledEllipse(point center, uint32_t radiusX, uint32_t radiusY, color color = colors::white);
+    void drawCircleAntiAliased(point center, uint32_t radius, color color = colors::white, uint32_t thickness = 1);
+    void drawFilledCircleAntiAliased(point center, uint32_t radius, color color = colors::white);
 
     void drawArc(point center, uint32_t radius, uint32_t start_angle, uint32_t end_angle, color color = colors::white);
     void drawFilledDualArc(point center, uint32_t innerRadius, uint32_t outerRadius, uint32_t startAngle, uint32_t endAngle, color color);
+    void drawArcAntiAliased(point center, uint32_t radius, uint32_t startAngle, uint32_t endAngle, color color = colors::white, uint32_t thickness = 1);
+    void drawFilledDualArcAntiAliased(point center, uint32_t innerRadius, uint32_t outerRadius, uint32_t startAngle, uint32_t endAngle, color color);
 
     void drawBitmap(const uint8_t* bitmap, uint32_t width, uint32_t height);
     void drawBitmap(const uint16_t* bitmap, uint32_t width, uint32_t height);
@@ -47,15 +108,36 @@ public:
     void drawBitmap(const uint16_t* bitmap, uint32_t width, uint32_t height, bool center);
     void drawBitmap(const uint8_t* bitmap, uint32_t width, uint32_t height, point start);
     void drawBitmap(const uint16_t* bitmap, uint32_t width, uint32_t height, point start);
+    void drawBitmap(const uint16_t* bitmap, uint32_t width, uint32_t height, point start, uint8_t alpha);
+    void drawBitmapMasked(const uint16_t* bitmap, const uint8_t* mask, uint32_t width, uint32_t height, point start);
 
     void addBayerFilter(void);
     void addFloydSteinbergDithering(void);
     void addAntiAliasingFilter(void);
     void addBlur(void);
     void addBlur(rect area);
+
+    void setFrameBuffer(uint16_t* frameBuffer);
+    uint16_t* getFrameBuffer(void) { return this->frameBuffer; }
+    void setBand(uint16_t* buffer, int32_t top, uint32_t rows);
+    void setDamageTracker(damageTracker* tracker) { this->damage = tracker; }
+
+    bool pushClip(rect area);
+    bool pushClip(point start, point end);
+    void popClip(void);
+    rect getClip(void);
 private:
     uint16_t* frameBuffer;
     display_config_t* config;
+    damageTracker* damage = nullptr;
+    // rows that can be drawn to, the whole display unless a band is set
+    int32_t bandTop = 0;
+    int32_t bandBottom = INT32_MAX;
+    // pushed clip rects, each one already cut down to the one below it
+    clip_t clipStack[GRAPHICS_CLIP_DEPTH];
+    size_t clipDepth = 0;
+    // the band cut down to the top clip rect, the display bounds are applied by getClipArea()
+    clip_t clip = { 0, 0, INT32_MAX, INT32_MAX };
     uint32_t width;
     uint32_t height;
 
@@ -66,10 +148,35 @@ private:
         15, 7, 13, 5
     };
 
-    inline void setPixel(uint32_t x, uint32_t y, uint16_t color) { this->frameBuffer[x + y * this->config->width] = color; }
-    void setPixelBlend(uint32_t x, uint32_t y, uint16_t background, uint8_t alpha);
+    inline clip_t getClipArea(void)
+    {
+        return { this->clip.left, this->clip.top, imin(this->clip.right, (int32_t)this->config->width), imin(this->clip.bottom, (int32_t)this->config->height) };
+    }
+    inline bool inClip(int32_t x, int32_t y)
+    {
+        return x >= this->clip.left && x < this->clip.right && x < (int32_t)this->config->width
+            && y >= this->clip.top && y < this->clip.bottom && y < (int32_t)this->config->height;
+    }
+    inline bool rejectClip(const clip_t& area, int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+    {
+        return x1 < area.left || x0 >= area.right || y1 < area.top || y0 >= area.bottom;
+    }
+    inline bool insideClip(const clip_t& area, int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+    {
+        return x0 >= area.left && x1 < area.right && y0 >= area.top && y1 < area.bottom;
+    }
+    inline void setPixel(int32_t x, int32_t y, uint16_t color) { if (this->inClip(x, y)) this->frameBuffer[x + y * this->config->width] = color; }
+    inline void markDamage(int32_t x0, int32_t y0, int32_t x1, int32_t y1) { if (this->damage != nullptr) this->damage->add(x0, y0, x1, y1); }
+    void updateClip(void);
+    void setPixelBlend(int32_t x, int32_t y, uint16_t background, uint8_t alpha);
     void drawCircle1(point center, uint32_t radius, color color);
     void drawCircle2(point center, uint32_t radius, color color, uint32_t thickness = 2);
-    void drawCircleXLine(uint32_t x1, uint32_t x2, uint32_t y, color color);
-    void drawCircleYLine(uint32_t x, uint32_t y1, uint32_t y2, color color);
+    void fillCircleRows(const clip_t& area, int32_t left, int32_t top, int32_t right, int32_t bottom, int32_t radius, uint16_t color);
+    void fillEllipseRows(const clip_t& area, int32_t left, int32_t top, int32_t right, int32_t bottom, int32_t radiusX, int32_t radiusY, uint16_t color);
+    void fillMirroredRows(const clip_t& area, int32_t left, int32_t top, int32_t right, int32_t bottom, int32_t offset, int32_t halfWidth, uint16_t color);
+    void drawCircleXLine(const clip_t& area, int32_t x1, int32_t x2, int32_t y, uint16_t color);
+    void drawCircleYLine(const clip_t& area, int32_t x, int32_t y1, int32_t y2, uint16_t color);
+    void strokePolyline(point* points, size_t numberOfPoints, uint32_t thickness, uint16_t color, line_cap_t cap, line_join_t join);
+    void fillRingAntiAliased(point center, int32_t outerEdge, int32_t innerEdge, int32_t startAngle, int32_t endAngle, uint16_t color);
+    void blendBitmap(const uint16_t* bitmap, const uint8_t* mask, uint32_t alpha, uint32_t width, uint32_t height, point start);
 };
\ No newline at end of file
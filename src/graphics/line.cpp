@@ -1,5 +1,389 @@
 #include "graphics.hpp"
 
+// Columns of a row standing in for no limit, far enough from the int32_t range to add a point to
+#define STROKE_RANGE (INT32_MAX / 4)
+
+// A straight part of a stroke, the direction is a unit vector and the length is in 16.16 fixed point
+typedef struct
+{
+    point start;
+    point end;
+    int32_t directionX;
+    int32_t directionY;
+    int32_t length;
+} stroke_segment_t;
+
+// The corner where two segments of a stroke meet, in 16.16 fixed point
+typedef struct
+{
+    point vertex;
+    int32_t beforeX;        // direction of the segment before the corner
+    int32_t beforeY;
+    int32_t afterX;         // direction of the segment after the corner
+    int32_t afterY;
+    int32_t sideX;          // pixels p with (p - vertex) . side < 0 belong to the segment before the corner
+    int32_t sideY;
+    line_join_t join;       // a miter past GRAPHICS_MITER_LIMIT is turned into a bevel
+    int32_t bevelX;         // unit vector pointing into the outer corner
+    int32_t bevelY;
+    int32_t bevelDistance;  // distance of the bevel from the vertex
+} stroke_join_t;
+
+// A segment with what is needed to draw it
+typedef struct
+{
+    stroke_segment_t segment;
+    const stroke_join_t* head;  // corner at the start, nullptr if the start gets a cap
+    const stroke_join_t* tail;  // corner at the end, nullptr if the end gets a cap
+    line_cap_t cap;
+    int32_t thickness;          // in pixels
+    int32_t halfWidth;          // in 16.16 fixed point
+    uint16_t color;
+} stroke_t;
+
+/**
+ * @brief Divide and round down
+ * @param numerator Number to divide
+ * @param denominator Number to divide by, not 0
+ * @return int64_t The quotient, rounded towards negative infinity
+*/
+static inline int64_t lineFloor(int64_t numerator, int64_t denominator)
+{
+    int64_t quotient = numerator / denominator;
+    if (numerator % denominator != 0 && (numerator < 0) != (denominator < 0))
+        quotient--;
+    return quotient;
+}
+
+/**
+ * @brief Cut a range of steps down to the steps that land inside a range of coordinates
+ * @param origin Coordinate of step 0
+ * @param sign 1 if the coordinate grows with every step, -1 if it shrinks
+ * @param low Lowest coordinate inside
+ * @param high Highest coordinate inside
+ * @param first First step, raised to the first step inside
+ * @param last Last step, lowered to the last step inside
+*/
+static inline void lineSteps(int32_t origin, int32_t sign, int32_t low, int32_t high, int32_t* first, int32_t* last)
+{
+    int32_t lowest = sign > 0 ? low - origin : origin - high;
+    int32_t highest = sign > 0 ? high - origin : origin - low;
+    *first = imax(*first, lowest);
+    *last = imin(*last, highest);
+}
+
+/**
+ * @brief Set up a segment between two points
+ * @param start Start point
+ * @param end End point, not the same as the start
+ * @return stroke_segment_t The segment
+*/
+static stroke_segment_t strokeSegment(point start, point end)
+{
+    int64_t dx = end.x - start.x;
+    int64_t dy = end.y - start.y;
+    int64_t length = isqrt64((uint64_t)(dx * dx + dy * dy) << (2 * FIXED_POINT_SCALE_BITS));
+
+    return { start, end, (int32_t)((dx << (2 * FIXED_POINT_SCALE_BITS)) / length), (int32_t)((dy << (2 * FIXED_POINT_SCALE_BITS)) / length), (int32_t)length };
+}
+
+/**
+ * @brief Set up the corner between two segments
+ * @param before Segment that ends at the corner
+ * @param after Segment that starts at the corner
+ * @param halfWidth Half the thickness of the stroke in 16.16 fixed point
+ * @param join How the corner is drawn
+ * @return stroke_join_t The corner
+*/
+static stroke_join_t strokeJoin(const stroke_segment_t& before, const stroke_segment_t& after, int32_t halfWidth, line_join_t join)
+{
+    stroke_join_t corner = { before.end, before.directionX, before.directionY, after.directionX, after.directionY, 0, 0, join, 0, 0, 0 };
+
+    // the pixels are split along the bisector of the corner, a line that turns
+    // all the way back splits them where it turns instead
+    corner.sideX = before.directionX + after.directionX;
+    corner.sideY = before.directionY + after.directionY;
+    if (iabs(corner.sideX) < 64 && iabs(corner.sideY) < 64)
+    {
+        corner.sideX = before.directionX;
+        corner.sideY = before.directionY;
+    }
+
+    // the outer corner points away from both lines, a straight line has none
+    int64_t turn = (int64_t)before.directionX * after.directionY - (int64_t)before.directionY * after.directionX;
+    int64_t outerX = before.directionX - after.directionX;
+    int64_t outerY = before.directionY - after.directionY;
+    int64_t outer = isqrt64((uint64_t)(outerX * outerX + outerY * outerY));
+    if (turn == 0 || outer == 0)
+    {
+        corner.join = JoinMiter;
+        return corner;
+    }
+
+    corner.bevelX = (int32_t)((outerX << FIXED_POINT_SCALE_BITS) / outer);
+    corner.bevelY = (int32_t)((outerY << FIXED_POINT_SCALE_BITS) / outer);
+
+    // the cosine of half the corner angle sets how far the miter and the bevel reach
+    int64_t cosine = (turn < 0 ? -turn : turn) / outer;
+    corner.bevelDistance = (int32_t)((halfWidth * cosine) >> FIXED_POINT_SCALE_BITS);
+    if (join == JoinMiter && cosine * GRAPHICS_MITER_LIMIT < FIXED_POINT_SCALE)
+        corner.join = JoinBevel;
+
+    return corner;
+}
+
+/**
+ * @brief Check which segment a pixel near a corner belongs to
+ * @param corner Corner to check
+ * @param x Column of the pixel
+ * @param y Row of the pixel
+ * @return bool True if the pixel belongs to the segment after the corner
+*/
+static inline bool strokeAfter(const stroke_join_t& corner, int32_t x, int32_t y)
+{
+    return (int64_t)(x - corner.vertex.x) * corner.sideX + (int64_t)(y - corner.vertex.y) * corner.sideY >= 0;
+}
+
+/**
+ * @brief Cut the coverage of a pixel down at one end of a segment
+ * @param stroke Stroke being drawn
+ * @param corner Corner at the end, nullptr if it gets a cap
+ * @param coverage Coverage of the pixel by the sides of the segment
+ * @param past Distance of the pixel past the end along the segment in 16.16 fixed point
+ * @param dx Column of the pixel relative to the end point
+ * @param dy Row of the pixel relative to the end point
+ * @return int32_t The coverage from 0 to COVERAGE_MAX
+*/
+static int32_t strokeEnd(const stroke_t& stroke, const stroke_join_t* corner, int32_t coverage, int32_t past, int32_t dx, int32_t dy)
+{
+    int32_t half = COVERAGE_MAX / 2;
+    bool round = corner == nullptr ? stroke.cap == CapRound : corner->join == JoinRound;
+    if (round)
+        return past > 0 ? icoverage(stroke.thickness, 4 * ((int64_t)dx * dx + (int64_t)dy * dy)) : coverage;
+
+    if (corner == nullptr)
+    {
+        int32_t extension = stroke.cap == CapSquare ? stroke.halfWidth : 0;
+        return imin(coverage, clamp(half + ((extension - past) >> 8), 0, COVERAGE_MAX));
+    }
+
+    if (corner->join == JoinBevel)
+    {
+        int32_t distance = dx * corner->bevelX + dy * corner->bevelY;
+        return imin(coverage, clamp(half + ((corner->bevelDistance - distance) >> 8), 0, COVERAGE_MAX));
+    }
+
+    return coverage;
+}
+
+/**
+ * @brief Get how much of a pixel the segment on the other side of a corner covers
+ * @param stroke Stroke being drawn
+ * @param corner Corner to check
+ * @param after True for the segment after the corner, false for the one before it
+ * @param x Column of the pixel
+ * @param y Row of the pixel
+ * @return int32_t The coverage from 0 to COVERAGE_MAX, the segment ends flat at the corner,
+ *         0 on the outer side of the corner and at a straight corner
+*/
+static int32_t strokeNeighbour(const stroke_t& stroke, const stroke_join_t& corner, bool after, int32_t x, int32_t y)
+{
+    int32_t dx = x - corner.vertex.x;
+    int32_t dy = y - corner.vertex.y;
+    if (dx * corner.bevelX + dy * corner.bevelY >= 0)
+        return 0;
+
+    int32_t directionX = after ? corner.afterX : corner.beforeX;
+    int32_t directionY = after ? corner.afterY : corner.beforeY;
+    int32_t along = dx * directionX + dy * directionY;
+    int32_t across = iabs(dy * directionX - dx * directionY);
+
+    int32_t half = COVERAGE_MAX / 2;
+    int32_t coverage = clamp(half + ((stroke.halfWidth - across) >> 8), 0, COVERAGE_MAX);
+    return imin(coverage, clamp(half + ((after ? along : -along) >> 8), 0, COVERAGE_MAX));
+}
+
+/**
+ * @brief Get how much of a pixel a segment of a stroke covers
+ * @param stroke Stroke being drawn
+ * @param x Column of the pixel
+ * @param y Row of the pixel
+ * @return int32_t The coverage from 0 to COVERAGE_MAX, 0 if the pixel belongs to another segment
+*/
+static int32_t strokeCoverage(const stroke_t& stroke, int32_t x, int32_t y)
+{
+    if (stroke.head != nullptr && !strokeAfter(*stroke.head, x, y))
+        return 0;
+    if (stroke.tail != nullptr && strokeAfter(*stroke.tail, x, y))
+        return 0;
+
+    const stroke_segment_t& segment = stroke.segment;
+    int32_t dx = x - segment.start.x;
+    int32_t dy = y - segment.start.y;
+    int32_t along = dx * segment.directionX + dy * segment.directionY;
+    int32_t across = iabs(dy * segment.directionX - dx * segment.directionY);
+    int32_t coverage = clamp(COVERAGE_MAX / 2 + ((stroke.halfWidth - across) >> 8), 0, COVERAGE_MAX);
+    if (coverage == 0)
+        return 0;
+
+    coverage = strokeEnd(stroke, stroke.head, coverage, -along, dx, dy);
+    coverage = strokeEnd(stroke, stroke.tail, coverage, along - segment.length, x - segment.end.x, y - segment.end.y);
+
+    // on the inside of a corner the edges of both segments cross the pixel, what one
+    // leaves uncovered the other covers about as much of as of the rest of the pixel
+    if (stroke.head != nullptr && coverage < COVERAGE_MAX)
+    {
+        int32_t other = strokeNeighbour(stroke, *stroke.head, false, x, y);
+        coverage += other - coverage * other / COVERAGE_MAX;
+    }
+    if (stroke.tail != nullptr && coverage < COVERAGE_MAX)
+    {
+        int32_t other = strokeNeighbour(stroke, *stroke.tail, true, x, y);
+        coverage += other - coverage * other / COVERAGE_MAX;
+    }
+    return coverage;
+}
+
+/**
+ * @brief Get the columns where a value that changes along a row stays within bounds
+ * @param a Change of the value per column
+ * @param c Value at column 0
+ * @param lower Lowest value that is kept
+ * @param upper Highest value that is kept
+ * @param range Gets the first and last column, first > last if there are none
+ * @note The columns are kept within STROKE_RANGE so a point can be added to them
+*/
+static void strokeRange(int32_t a, int64_t c, int64_t lower, int64_t upper, int32_t* range)
+{
+    int64_t first = -STROKE_RANGE;
+    int64_t last = STROKE_RANGE;
+    if (a > 0)
+    {
+        first = -lineFloor(c - lower, a);
+        last = lineFloor(upper - c, a);
+    }
+    else if (a < 0)
+    {
+        first = -lineFloor(upper - c, -a);
+        last = lineFloor(c - lower, -a);
+    }
+    else if (c < lower || c > upper)
+    {
+        first = STROKE_RANGE;
+        last = -STROKE_RANGE;
+    }
+
+    range[0] = (int32_t)(first < -STROKE_RANGE ? -STROKE_RANGE : first > STROKE_RANGE ? STROKE_RANGE : first);
+    range[1] = (int32_t)(last < -STROKE_RANGE ? -STROKE_RANGE : last > STROKE_RANGE ? STROKE_RANGE : last);
+    if (range[0] == range[1] && first > last)
+        range[1] = range[0] - 1;
+}
+
+/**
+ * @brief Blend the pixels of a row a segment covers part of
+ * @param row First pixel of the row
+ * @param stroke Stroke being drawn
+ * @param y Row
+ * @param x1 First column
+ * @param x2 Last column
+*/
+static void strokeBlend(uint16_t* row, const stroke_t& stroke, int32_t y, int32_t x1, int32_t x2)
+{
+    for (int32_t x = x1; x <= x2; x++)
+    {
+        uint32_t alpha = (strokeCoverage(stroke, x, y) * SPAN_ALPHA_MAX + COVERAGE_MAX / 2) / COVERAGE_MAX;
+        if (alpha > 0)
+            row[x] = blendPixel(row[x], stroke.color, alpha);
+    }
+}
+
+/**
+ * @brief Get how far the pixels a segment touches reach past one of its ends
+ * @param stroke Stroke being drawn
+ * @param corner Corner at the end, nullptr if it gets a cap
+ * @return int32_t The distance in 16.16 fixed point
+*/
+static int32_t strokeReach(const stroke_t& stroke, const stroke_join_t* corner)
+{
+    int32_t pixel = FIXED_POINT_SCALE;
+    if (corner == nullptr)
+        return stroke.cap == CapButt ? pixel : stroke.halfWidth + pixel;
+
+    return corner->join == JoinMiter ? stroke.halfWidth * GRAPHICS_MITER_LIMIT + pixel : stroke.halfWidth + pixel;
+}
+
+/**
+ * @brief Get how far the pixels a segment fully covers reach past one of its ends
+ * @param stroke Stroke being drawn
+ * @param corner Corner at the end, nullptr if it gets a cap
+ * @return int32_t The distance in 16.16 fixed point, negative if they stop short of the end
+*/
+static int32_t strokeSolidReach(const stroke_t& stroke, const stroke_join_t* corner)
+{
+    int32_t half = FIXED_POINT_SCALE / 2;
+    if (corner != nullptr || stroke.cap == CapRound)
+        return 0;
+
+    return stroke.cap == CapSquare ? stroke.halfWidth - half : -half;
+}
+
+/**
+ * @brief Draw one segment of a stroke
+ * @param frameBuffer Frame buffer to draw in
+ * @param width Width of the frame buffer
+ * @param area Clip area
+ * @param stroke Stroke and segment to draw
+ * @note The pixels fully inside the segment are filled as a span, the ones on its edges are blended
+*/
+static void strokeDraw(uint16_t* frameBuffer, uint32_t width, const clip_t& area, const stroke_t& stroke)
+{
+    const stroke_segment_t& segment = stroke.segment;
+    int32_t pixel = FIXED_POINT_SCALE;
+    int32_t headReach = strokeReach(stroke, stroke.head);
+    int32_t tailReach = strokeReach(stroke, stroke.tail);
+    int32_t headSolid = strokeSolidReach(stroke, stroke.head);
+    int32_t tailSolid = strokeSolidReach(stroke, stroke.tail);
+    int32_t solidWidth = stroke.halfWidth - pixel / 2;
+
+    int32_t reach = ((imax(headReach, tailReach) + stroke.halfWidth) >> FIXED_POINT_SCALE_BITS) + 1;
+    int32_t top = imax(imin(segment.start.y, segment.end.y) - reach, area.top);
+    int32_t bottom = imin(imax(segment.start.y, segment.end.y) + reach, area.bottom - 1);
+    for (int32_t y = top; y <= bottom; y++)
+    {
+        // the columns near enough to the segment, then the ones fully inside it
+        int32_t dy = y - segment.start.y;
+        int32_t across[2];
+        int32_t along[2];
+        strokeRange(-segment.directionY, (int64_t)dy * segment.directionX, -(stroke.halfWidth + pixel), stroke.halfWidth + pixel, across);
+        strokeRange(segment.directionX, (int64_t)dy * segment.directionY, -headReach, (int64_t)segment.length + tailReach, along);
+        int32_t first = imax(imax(across[0], along[0]) + segment.start.x, area.left);
+        int32_t last = imin(imin(across[1], along[1]) + segment.start.x, area.right - 1);
+        if (first > last)
+            continue;
+
+        uint16_t* row = frameBuffer + y * width;
+        if (solidWidth < 0)
+        {
+            strokeBlend(row, stroke, y, first, last);
+            continue;
+        }
+
+        strokeRange(-segment.directionY, (int64_t)dy * segment.directionX, -solidWidth, solidWidth, across);
+        strokeRange(segment.directionX, (int64_t)dy * segment.directionY, -headSolid, (int64_t)segment.length + tailSolid, along);
+        int32_t solidFirst = imax(imax(across[0], along[0]) + segment.start.x, first);
+        int32_t solidLast = imin(imin(across[1], along[1]) + segment.start.x, last);
+        if (solidFirst > solidLast)
+        {
+            strokeBlend(row, stroke, y, first, last);
+            continue;
+        }
+
+        strokeBlend(row, stroke, y, first, solidFirst - 1);
+        fillSpan(row + solidFirst, stroke.color, solidLast - solidFirst + 1);
+        strokeBlend(row, stroke, y, solidLast + 1, last);
+    }
+}
+
 /**
  * @brief Draw a line on the display
  * @param start Start point
@@ -8,42 +392,87 @@
 */
 void graphics::drawLine(point start, point end, color color)
 {
-    // Uses an optimized Bresenham's line algorithm
-    // http://members.chello.at/~easyfilter/bresenham.html
+    PROFILE_SCOPE("drawLine", profileLength(start, end));
+
+    this->markDamage(imin(start.x, end.x), imin(start.y, end.y), imax(start.x, end.x), imax(start.y, end.y));
 
-    // Find the delta x and start x
-    int32_t dx = iabs(end.x - start.x), sx = start.x < end.x ? 1 : -1;
-    // Find the delta y and start y
-    int32_t dy = -iabs(end.y - start.y), sy = start.y < end.y ? 1 : -1;
-    // Calculate the error
-    int32_t err = dx + dy, e2;
-    // Get the uint16_t color
     uint16_t color16 = color.to16bit(this->config->inverseColors);
+    int32_t width = this->config->width;
+    clip_t area = this->getClipArea();
 
-    uint32_t x = start.x;
-    uint32_t y = start.y;
+    // horizontal and vertical lines are a span or a column
+    if (start.y == end.y)
+    {
+        int32_t left = imax(imin(start.x, end.x), area.left);
+        int32_t right = imin(imax(start.x, end.x) + 1, area.right);
+        if (start.y >= area.top && start.y < area.bottom && left < right)
+            fillSpan(this->frameBuffer + left + start.y * width, color16, right - left);
+        return;
+    }
+    if (start.x == end.x)
+    {
+        int32_t top = imax(imin(start.y, end.y), area.top);
+        int32_t bottom = imin(imax(start.y, end.y) + 1, area.bottom);
+        if (start.x >= area.left && start.x < area.right && top < bottom)
+            fillColumn(this->frameBuffer + start.x + top * width, width, color16, bottom - top);
+        return;
+    }
 
-    // Loop until we break
-    for (;;)
+    // Bresenham's line algorithm steps along the longer axis and moves along the
+    // shorter one when the error passes half a pixel, so step i has moved
+    // (2 * i * minor + major) / (2 * major) times
+    int32_t dx = end.x - start.x, dy = end.y - start.y;
+    bool steep = iabs(dy) > iabs(dx);
+    int32_t major = steep ? iabs(dy) : iabs(dx);
+    int32_t minor = steep ? iabs(dx) : iabs(dy);
+    int32_t majorSign = (steep ? dy : dx) > 0 ? 1 : -1;
+    int32_t minorSign = (steep ? dx : dy) > 0 ? 1 : -1;
+
+    // cut the steps down to the clip area along the longer axis
+    int32_t first = 0, last = major;
+    if (steep)
+        lineSteps(start.y, majorSign, area.top, area.bottom - 1, &first, &last);
+    else
+        lineSteps(start.x, majorSign, area.left, area.right - 1, &first, &last);
+
+    // and along the shorter axis, where the moves are turned back into steps
+    int32_t lowest = 0, highest = minor;
+    if (steep)
+        lineSteps(start.x, minorSign, area.left, area.right - 1, &lowest, &highest);
+    else
+        lineSteps(start.y, minorSign, area.top, area.bottom - 1, &lowest, &highest);
+    if (lowest > highest)
+        return;
+    int64_t firstMoved = -lineFloor((int64_t)major - 2 * (int64_t)lowest * major, 2 * (int64_t)minor);
+    int64_t lastMoved = lineFloor(2 * (int64_t)highest * major + major - 1, 2 * (int64_t)minor);
+    if (firstMoved > first)
+        first = firstMoved > last ? last + 1 : (int32_t)firstMoved;
+    if (lastMoved < last)
+        last = lastMoved < first ? first - 1 : (int32_t)lastMoved;
+    if (first > last)
+        return;
+
+    // start at the first step inside, everything from there on is inside as well
+    int64_t numerator = 2 * (int64_t)first * minor + major;
+    int32_t moved = (int32_t)(numerator / (2 * major));
+    int32_t error = (int32_t)(numerator % (2 * major));
+    int32_t x = start.x + (steep ? minorSign * moved : majorSign * first);
+    int32_t y = start.y + (steep ? majorSign * first : minorSign * moved);
+    int32_t majorStride = steep ? majorSign * width : majorSign;
+    int32_t minorStride = steep ? minorSign : minorSign * width;
+    uint16_t* pixel = this->frameBuffer + x + y * width;
+
+    for (int32_t steps = last - first; ; steps--)
     {
-        // Set the pixel at the current position
-        this->frameBuffer[x + y * this->config->width] = color16;
-        // Check if we are at the end
-        if (x == end.x && y == end.y) 
+        *pixel = color16;
+        if (steps == 0)
             break;
-        // Calculate the new error
-        e2 = 2 * err;
-        // Check if we should move in the x direction
-        if (e2 >= dy) 
+        pixel += majorStride;
+        error += 2 * minor;
+        if (error >= 2 * major)
         {
-            err += dy; 
-            x += sx; 
-        }
-        // Check if we should move in the y direction
-        if (e2 <= dx) 
-        { 
-            err += dx; 
-            y += sy; 
+            error -= 2 * major;
+            pixel += minorStride;
         }
     }
 }
@@ -56,13 +485,17 @@ void graphics::drawLine(point start, point end, color color)
 */
 void graphics::drawLineAntiAliased(point start, point end, color color)
 {
+    PROFILE_SCOPE("drawLineAntiAliased", profileLength(start, end));
+
+    this->markDamage(imin(start.x, end.x) - 1, imin(start.y, end.y) - 1, imax(start.x, end.x) + 1, imax(start.y, end.y) + 1);
+
     // Uses an optimized Bresenham's line algorithm
     // http://members.chello.at/~easyfilter/bresenham.html
 
     // Find the delta x and start x
     int32_t dx = iabs(end.x - start.x), sx = start.x < end.x ? 1 : -1;
     // Find the delta y and start y
-    int32_t dy = -iabs(end.y - start.y), sy = start.y < end.y ? 1 : -1;
+    int32_t dy = iabs(end.y - start.y), sy = start.y < end.y ? 1 : -1;
     // Calculate the error
     int32_t err = dx - dy;
     int32_t e2, x2;
@@ -72,13 +505,16 @@ void graphics::drawLineAntiAliased(point start, point end, color color)
     // Get the uint16_t color
     uint16_t color16 = color.to16bit(this->config->inverseColors);
 
+    // skip lines that are outside of the clip area, the blended pixels are checked one by one
+    if (this->rejectClip(this->getClipArea(), imin(start.x, end.x) - 1, imin(start.y, end.y) - 1, imax(start.x, end.x) + 1, imax(start.y, end.y) + 1))
+        return;
+
     // Loop until we break
     for (;;)
     {
-        // Set the pixel at the current position
-        uint8_t alpha = 255 * iabs(err - dx + dy) * edInv;
-        alpha >>= FIXED_POINT_SCALE_BITS;
-        this->setPixelBlend(start.x, start.y, color16, alpha);
+        // Set the pixel at the current position, the error is the distance from the line
+        int32_t alpha = 255 - ((255 * iabs(err - dx + dy) * edInv) >> FIXED_POINT_SCALE_BITS);
+        this->setPixelBlend(start.x, start.y, color16, imax(alpha, 0));
         // Calculate the new error
         e2 = err; x2 = start.x;
 
@@ -91,9 +527,8 @@ void graphics::drawLineAntiAliased(point start, point end, color color)
             if (e2 + dy < ed)
             {
                 // Handle the anti-aliasing
-                alpha = 255 * (e2 + dy) * edInv;
-                alpha >>= FIXED_POINT_SCALE_BITS;
-                this->setPixelBlend(start.x, start.y + sy, color16, alpha);
+                alpha = 255 - ((255 * (e2 + dy) * edInv) >> FIXED_POINT_SCALE_BITS);
+                this->setPixelBlend(start.x, start.y + sy, color16, imax(alpha, 0));
             }
             // Update the error
             err -= dy; start.x += sx;
@@ -107,9 +542,8 @@ void graphics::drawLineAntiAliased(point start, point end, color color)
             if (dx - e2 < ed)
             {
                 // Handle the anti-aliasing
-                alpha = 255 * (dx - e2) * edInv;
-                alpha >>= FIXED_POINT_SCALE_BITS;
-                this->setPixelBlend(x2 + sx, start.y, color16, alpha);
+                alpha = 255 - ((255 * (dx - e2) * edInv) >> FIXED_POINT_SCALE_BITS);
+                this->setPixelBlend(x2 + sx, start.y, color16, imax(alpha, 0));
             }
             // Update the error
             err += dx; start.y += sy;
@@ -121,22 +555,108 @@ void graphics::drawLineAntiAliased(point start, point end, color color)
  * @brief Draw a thick line on the display with anti-aliasing
  * @param start Start point
  * @param end End point
- * @param thickness Thickness of the line, value must be greater than 1
+ * @param thickness Thickness of the line
  * @param color color to draw in
+ * @param cap How the ends of the line are drawn
 */
-void graphics::drawLineThickAntiAliased(point start, point end, uint32_t thickness, color color)
+void graphics::drawLineThickAntiAliased(point start, point end, uint32_t thickness, color color, line_cap_t cap)
 {
-    // Uses an optimized Bresenham's line algorithm
-    // http://members.chello.at/~easyfilter/bresenham.html
+    PROFILE_SCOPE("drawLineThickAntiAliased", profileLength(start, end) * thickness);
 
-    // Find the delta x and start x
-    int32_t dx = iabs(end.x - start.x), sx = start.x < end.x ? 1 : -1;
-    // Find the delta y and start y
-    int32_t dy = -iabs(end.y - start.y), sy = start.y < end.y ? 1 : -1;
-    // Calculate the error
-    int32_t err = dx - dy;
-    int32_t e2, x2, y2;
-    int32_t ed = dx + dy == 0 ? 1 : isqrt(dx * dx + dy * dy);
-    // Get the uint16_t color
-    uint16_t color16 = color.to16bit(this->config->inverseColors);
+    point points[2] = { start, end };
+    this->strokePolyline(points, 2, thickness, color.to16bit(this->config->inverseColors), cap, JoinMiter);
+}
+
+/**
+ * @brief Draw connected lines on the display with anti-aliasing
+ * @param points Points to connect, in order
+ * @param numberOfPoints Number of points, at least 2
+ * @param thickness Thickness of the lines
+ * @param color color to draw in
+ * @param cap How the ends of the first and last line are drawn
+ * @param join How the lines are joined where they meet
+ * @note Every pixel is blended once, also where the lines meet
+*/
+void graphics::drawPolyline(point* points, size_t numberOfPoints, uint32_t thickness, color color, line_cap_t cap, line_join_t join)
+{
+    PROFILE_SCOPE("drawPolyline", profilePolylineLength(points, numberOfPoints) * thickness);
+
+    this->strokePolyline(points, numberOfPoints, thickness, color.to16bit(this->config->inverseColors), cap, join);
+}
+
+/**
+ * @private
+ * @brief Draw connected lines with anti-aliasing
+ * @param points Points to connect, in order
+ * @param numberOfPoints Number of points, at least 2
+ * @param thickness Thickness of the lines
+ * @param color 16 bit color to draw in
+ * @param cap How the ends of the first and last line are drawn
+ * @param join How the lines are joined where they meet
+ * @note The pixels around a join are split between the two lines by the line through the
+ *       corner, each line draws its own side of it as if it went on, so nothing is blended twice
+*/
+void graphics::strokePolyline(point* points, size_t numberOfPoints, uint32_t thickness, uint16_t color, line_cap_t cap, line_join_t join)
+{
+    if (numberOfPoints < 2 || thickness == 0)
+        return;
+
+    // a miter reaches furthest past the points
+    int32_t reach = ((int32_t)thickness * GRAPHICS_MITER_LIMIT + 1) / 2 + 2;
+    int32_t left = INT32_MAX, top = INT32_MAX, right = INT32_MIN, bottom = INT32_MIN;
+    for (size_t i = 0; i < numberOfPoints; i++)
+    {
+        left = imin(left, points[i].x);
+        top = imin(top, points[i].y);
+        right = imax(right, points[i].x);
+        bottom = imax(bottom, points[i].y);
+    }
+    this->markDamage(left - reach, top - reach, right + reach, bottom + reach);
+
+    clip_t area = this->getClipArea();
+    if (this->rejectClip(area, left - reach, top - reach, right + reach, bottom + reach))
+        return;
+
+    stroke_t stroke;
+    stroke.cap = cap;
+    stroke.thickness = (int32_t)thickness;
+    stroke.halfWidth = (int32_t)thickness << (FIXED_POINT_SCALE_BITS - 1);
+    stroke.color = color;
+
+    // points that repeat the one before them are skipped
+    size_t i = 1;
+    while (i < numberOfPoints && points[i] == points[0])
+        i++;
+    if (i == numberOfPoints)
+        return;
+
+    stroke_segment_t segment = strokeSegment(points[0], points[i]);
+    stroke_join_t head;
+    stroke_join_t tail;
+    stroke.head = nullptr;
+    for (;;)
+    {
+        size_t next = i + 1;
+        while (next < numberOfPoints && points[next] == points[i])
+            next++;
+
+        stroke.segment = segment;
+        stroke.tail = nullptr;
+        stroke_segment_t following;
+        if (next < numberOfPoints)
+        {
+            following = strokeSegment(points[i], points[next]);
+            tail = strokeJoin(segment, following, stroke.halfWidth, join);
+            stroke.tail = &tail;
+        }
+        strokeDraw(this->frameBuffer, this->config->width, area, stroke);
+
+        if (next >= numberOfPoints)
+            break;
+
+        head = tail;
+        stroke.head = &head;
+        segment = following;
+        i = next;
+    }
 }
\ No newline at end of file
@@ -1,5 +1,103 @@
 #include "graphics.hpp"
 
+// An edge of a filled polygon, x is in 32.32 fixed point like the triangle edges
+typedef struct
+{
+    int64_t x;          // x at the current row
+    int64_t step;       // x added per row
+    int16_t top;        // first row the edge crosses, within the scanned rows
+    int16_t bottom;     // first row below the edge, within the scanned rows
+    int16_t winding;    // 1 for edges going down, -1 for edges going up
+} polygon_edge_t;
+
+/**
+ * @brief Get the upper and lower end of a polygon edge
+ * @param points Points of the polygon
+ * @param numberOfPoints Number of points
+ * @param index Edge to get, it runs from this point to the next
+ * @param from Filled with the upper end of the edge
+ * @param to Filled with the lower end of the edge
+ * @return int32_t 1 for edges going down, -1 for edges going up, 0 for horizontal edges
+*/
+static inline int32_t polygonEnds(const point* points, size_t numberOfPoints, size_t index, point* from, point* to)
+{
+    *from = points[index];
+    *to = points[index + 1 == numberOfPoints ? 0 : index + 1];
+    if (from->y == to->y)
+        return 0;
+    if (from->y < to->y)
+        return 1;
+
+    point swap = *from;
+    *from = *to;
+    *to = swap;
+    return -1;
+}
+
+/**
+ * @brief Find where a polygon edge crosses a row
+ * @param from Upper end of the edge
+ * @param to Lower end of the edge, below from
+ * @param row Row to cross, at or below from
+ * @param step Filled with the x added per row
+ * @return int64_t x on the row in 32.32 fixed point
+*/
+static inline int64_t polygonX(point from, point to, int32_t row, int64_t* step)
+{
+    // step in 32.32 fixed point, rounded down so the walked x never ends up right of the edge
+    int64_t numerator = (int64_t)(to.x - from.x) << 32;
+    int32_t height = to.y - from.y;
+    *step = numerator / height;
+    if (numerator % height != 0 && numerator < 0)
+        (*step)--;
+
+    return ((int64_t)from.x << 32) + *step * (row - from.y);
+}
+
+/**
+ * @brief Find how many rows from a row on can be filled with a limited number of edges
+ * @param points Points of the polygon
+ * @param numberOfPoints Number of points
+ * @param top First row of the band
+ * @param lastY Row below the last one that is scanned
+ * @param capacity Number of edges there is room for, at most GRAPHICS_POLYGON_EDGES
+ * @return int32_t Row below the band, top if the first row alone crosses too many edges
+*/
+static int32_t polygonBand(const point* points, size_t numberOfPoints, int32_t top, int32_t lastY, size_t capacity)
+{
+    // the rows where the edges further down start, only the smallest ones are kept sorted
+    int32_t starts[GRAPHICS_POLYGON_EDGES + 1];
+    size_t startCount = 0;
+    size_t crossing = 0;
+
+    for (size_t i = 0; i < numberOfPoints; i++)
+    {
+        point from, to;
+        if (polygonEnds(points, numberOfPoints, i, &from, &to) == 0 || to.y <= top || from.y >= lastY)
+            continue;
+
+        if (from.y <= top)
+        {
+            if (++crossing > capacity)
+                return top;
+            continue;
+        }
+
+        size_t j = startCount <= capacity ? startCount++ : capacity + 1;
+        for (; j > 0 && starts[j - 1] > from.y; j--)
+        {
+            if (j <= capacity)
+                starts[j] = starts[j - 1];
+        }
+        if (j <= capacity)
+            starts[j] = from.y;
+    }
+
+    // the band ends on the row where one more edge would start than there is room for
+    size_t room = capacity - crossing;
+    return room < startCount ? starts[room] : lastY;
+}
+
 /**
  * @brief Draw a rectangle on the display
  * @param start Start point
@@ -9,13 +107,9 @@
 */
 void graphics::drawRectangle(point start, point end, color color)
 {
-    // limit the start and end points to the display
-    start.x = imax(0, imin(start.x, this->config->width - 1));
-    start.y = imax(0, imin(start.y, this->config->height - 1));
-    end.x = imax(0, imin(end.x, this->config->width - 1));
-    end.y = imax(0, imin(end.y, this->config->height - 1));
+    PROFILE_SCOPE("drawRectangle", 2 * (iabs(end.x - start.x) + iabs(end.y - start.y)));
 
-    // draw the rectangle
+    // the edges are horizontal and vertical lines, drawLine clips them
     this->drawLine({start.x, start.y}, {end.x, start.y}, color);
     this->drawLine({end.x, start.y}, {end.x, end.y}, color);
     this->drawLine({end.x, end.y}, {start.x, end.y}, color);
@@ -60,27 +154,75 @@ void graphics::drawRectangle(point center, uint32_t width, uint32_t height, colo
 */
 void graphics::drawFilledRectangle(point start, point end, color color)
 {
+    PROFILE_SCOPE("drawFilledRectangle", (end.x - start.x) * (end.y - start.y));
+
+    this->markDamage(start.x, start.y, end.x - 1, end.y - 1);
+
     // convert color to 16 bit
     uint16_t color16 = color.to16bit(this->config->inverseColors);
 
-    // calculate the size of the rectangle
-    uint32_t width = end.x - start.x;
-    uint32_t height = end.y - start.y;
+    // cut the rectangle down to the clip area
+    clip_t area = this->getClipArea();
+    int32_t left = imax(start.x, area.left);
+    int32_t right = imin(end.x, area.right);
+    int32_t top = imax(start.y, area.top);
+    int32_t bottom = imin(end.y, area.bottom);
+    if (left < right && top < bottom)
+        fillRect(this->frameBuffer + left + top * this->config->width, this->config->width, color16, right - left, bottom - top);
+}
 
-    // loop through the height
-    for (int32_t i = 0; i < height; i++)
-    {
-        // loop through the width
-        for (int32_t j = 0; j < width; j++)
-        {
-            // write the pixel
-            this->frameBuffer[(start.x + j) + (start.y + i) * this->config->width] = color16;
-        }
-    }
+/**
+ * @brief Draw a filled rectangle with rounded corners on the display
+ * @param start Start point
+ * @param end End point, not part of the rectangle
+ * @param radius Radius of the corners, limited to half the shortest side
+ * @param color color to draw in
+*/
+void graphics::drawFilledRoundedRectangle(point start, point end, uint32_t radius, color color)
+{
+    PROFILE_SCOPE("drawFilledRoundedRectangle", (end.x - start.x) * (end.y - start.y));
+
+    this->markDamage(start.x, start.y, end.x - 1, end.y - 1);
+
+    if (end.x <= start.x || end.y <= start.y)
+        return;
+
+    // the corners are a circle split around the inner rectangle
+    int32_t corner = imin(radius, imin(end.x - start.x - 1, end.y - start.y - 1) / 2);
+    clip_t area = this->getClipArea();
+    this->fillCircleRows(area, start.x + corner, start.y + corner, end.x - 1 - corner, end.y - 1 - corner, corner, color.to16bit(this->config->inverseColors));
+}
+
+/**
+ * @brief Draw a see-through filled rectangle on the display
+ * @param start Start point
+ * @param end End point, not part of the rectangle
+ * @param color color to draw in
+ * @param alpha Alpha value of the color, 0 is transparent, 255 is opaque
+*/
+void graphics::drawTranslucentRectangle(point start, point end, color color, uint8_t alpha)
+{
+    PROFILE_SCOPE("drawTranslucentRectangle", (end.x - start.x) * (end.y - start.y));
+
+    this->markDamage(start.x, start.y, end.x - 1, end.y - 1);
+
+    // cut the rectangle down to the clip area
+    clip_t area = this->getClipArea();
+    int32_t left = imax(start.x, area.left);
+    int32_t right = imin(end.x, area.right);
+    int32_t top = imax(start.y, area.top);
+    int32_t bottom = imin(end.y, area.bottom);
+    if (left >= right || top >= bottom)
+        return;
+
+    uint16_t color16 = color.to16bit(this->config->inverseColors);
+    blendRect(this->frameBuffer + left + top * this->config->width, this->config->width, color16, spanAlpha(alpha), right - left, bottom - top);
 }
 
 void graphics::drawPolygon(point* points, size_t numberOfPoints, color color)
 {
+    PROFILE_SCOPE("drawPolygon", profilePolygonLength(points, numberOfPoints));
+
     // Make sure theres at least 3 points
     if (numberOfPoints < 3) return;
 
@@ -93,63 +235,197 @@ void graphics::drawPolygon(point* points, size_t numberOfPoints, color color)
 	this->drawLine(points[numberOfPoints - 1], points[0], color);
 }
 
-void graphics::drawFilledPolygon(point* points, size_t numberOfPoints, color color)
+/**
+ * @brief Fill a row of a polygon that crosses more edges than fit in the edge table
+ * @param frameBuffer Frame buffer to draw in
+ * @param width Width of the frame buffer
+ * @param area Clip area
+ * @param points Points of the polygon
+ * @param numberOfPoints Number of points
+ * @param y Row to fill
+ * @param color16 Color to fill with
+ * @param rule How overlapping parts of the outline decide what is inside
+ * @note Each crossing is found by going over every edge, which is slow but needs no memory
+*/
+static void polygonRow(uint16_t* frameBuffer, int32_t width, const clip_t& area, const point* points, size_t numberOfPoints, int32_t y, uint16_t color16, fill_rule_t rule)
+{
+    int32_t winding = 0;
+    int32_t startX = 0;
+    int64_t previousX = INT64_MIN;
+    size_t previousEdge = SIZE_MAX;
+
+    for (;;)
+    {
+        // the next crossing to the right, edges at the same x are taken in order
+        size_t nextEdge = SIZE_MAX;
+        int64_t nextX = INT64_MAX;
+        int32_t nextWinding = 0;
+        for (size_t i = 0; i < numberOfPoints; i++)
+        {
+            point from, to;
+            int32_t edgeWinding = polygonEnds(points, numberOfPoints, i, &from, &to);
+            if (edgeWinding == 0 || from.y > y || to.y <= y)
+                continue;
+
+            int64_t step;
+            int64_t x = polygonX(from, to, y, &step);
+            bool after = x > previousX || (x == previousX && previousEdge != SIZE_MAX && i > previousEdge);
+            if (after && (x < nextX || (x == nextX && i < nextEdge)))
+            {
+                nextX = x;
+                nextEdge = i;
+                nextWinding = edgeWinding;
+            }
+        }
+        if (nextEdge == SIZE_MAX)
+            return;
+        previousX = nextX;
+        previousEdge = nextEdge;
+
+        bool wasInside = rule == FillEvenOdd ? (winding & 1) : winding != 0;
+        winding += nextWinding;
+        bool isInside = rule == FillEvenOdd ? (winding & 1) : winding != 0;
+
+        int32_t x = (int32_t)((nextX + 0xffffffffLL) >> 32);
+        if (!wasInside && isInside)
+            startX = x;
+        else if (wasInside && !isInside)
+        {
+            int32_t left = imax(startX, area.left);
+            int32_t right = imin(x, area.right);
+            if (right > left)
+                fillSpan(frameBuffer + left + y * width, color16, right - left);
+        }
+    }
+}
+
+/**
+ * @brief Draw a filled polygon on the display
+ * @param points Points of the polygon, the last one connects back to the first
+ * @param numberOfPoints Number of points, at least 3
+ * @param color color to draw in
+ * @param rule How overlapping parts of the outline decide what is inside
+ * @note Follows the same edge rule as drawFilledTriangle(), pixels on the left and top edges are filled.
+ * Polygons with more than GRAPHICS_POLYGON_EDGES edges are filled in bands of rows
+*/
+void graphics::drawFilledPolygon(point* points, size_t numberOfPoints, color color, fill_rule_t rule)
 {
+    PROFILE_SCOPE("drawFilledPolygon", profilePolygonArea(points, numberOfPoints));
+
     // Make sure theres at least 3 points
     if (numberOfPoints < 3) return;
 
-    // Set the min and max values to the absolute max and min
-    int32_t minX = 0xffffffff;
-    int32_t maxX = 0;
-    int32_t minY = 0xffffffff;
-    int32_t maxY = 0;
+    // Calculate the bounding box of the polygon
+    int32_t minX = INT32_MAX;
+    int32_t maxX = INT32_MIN;
+    int32_t minY = INT32_MAX;
+    int32_t maxY = INT32_MIN;
+    for (size_t i = 0; i < numberOfPoints; i++)
+    {
+        minX = imin(minX, points[i].x);
+        maxX = imax(maxX, points[i].x);
+        minY = imin(minY, points[i].y);
+        maxY = imax(maxY, points[i].y);
+    }
+    this->markDamage(minX, minY, maxX, maxY);
+
+    clip_t area = this->getClipArea();
+    if (this->rejectClip(area, minX, minY, maxX, maxY))
+        return;
 
     // Get the uint16_t version of the color
     uint16_t color16 = color.to16bit(this->config->inverseColors);
 
-    // Calculate the bounding box of the polygon by first finding the min and max x and y values
-    for (int32_t i = 0; i < numberOfPoints; i++)
+    // only the rows in the clip area are scanned
+    int32_t firstY = imax(minY, area.top);
+    int32_t lastY = imin(maxY, area.bottom);
+
+    polygon_edge_t edges[GRAPHICS_POLYGON_EDGES];
+    polygon_edge_t* active[GRAPHICS_POLYGON_EDGES];
+    for (int32_t top = firstY; top < lastY;)
     {
-        // Check if the x value is less than the min x value
-        if(points[i].x < minX) minX = points[i].x;
-        // Check if the x value is greater than the max x value
-        if(points[i].x > maxX) maxX = points[i].x;
-        // Check if the y value is less than the min y value
-        if(points[i].y < minY) minY = points[i].y;
-        // Check if the y value is greater than the max y value
-		if(points[i].y > maxY) maxY = points[i].y;
-    }
+        // as many rows as the edge table holds the edges of, a row crossing too many edges goes on its own
+        int32_t bottom = polygonBand(points, numberOfPoints, top, lastY, GRAPHICS_POLYGON_EDGES);
+        if (bottom == top)
+        {
+            polygonRow(this->frameBuffer, this->config->width, area, points, numberOfPoints, top++, color16, rule);
+            continue;
+        }
 
-    // Implement a scanline algorithm to fill in the polygon
-    for (int32_t y = minY; y <= maxY; y++) {
-        int32_t xStart = maxX;
-        int32_t xEnd = minX;
+        // Build the edge table, sorted by the row the edges start on, horizontal edges add nothing
+        size_t edgeCount = 0;
+        for (size_t i = 0; i < numberOfPoints; i++)
+        {
+            point from, to;
+            int32_t winding = polygonEnds(points, numberOfPoints, i, &from, &to);
+
+            // skip the edges that end before the first row or start after the last one
+            if (winding == 0 || to.y <= top || from.y >= bottom)
+                continue;
 
-        // Iterate over the edges of the polygon, finding intersections with the scanline
-        for (int32_t i = 0; i < numberOfPoints; i++) {
-            int32_t nextIndex = i + 1;
-            // Manually handle the wrap-around condition
-            if (nextIndex == numberOfPoints) nextIndex = 0;
+            polygon_edge_t edge;
+            edge.top = imax(from.y, top);
+            edge.bottom = imin(to.y, bottom);
+            edge.winding = winding;
+            edge.x = polygonX(from, to, edge.top, &edge.step);
 
-            int32_t deltaY = points[nextIndex].y - points[i].y;
-            // Check if the scanline intersects with this edge
-            if ((points[i].y <= y && points[nextIndex].y > y) || (points[nextIndex].y <= y && points[i].y > y))
+            size_t j = edgeCount++;
+            for (; j > 0 && edges[j - 1].top > edge.top; j--)
+                edges[j] = edges[j - 1];
+            edges[j] = edge;
+        }
+
+        // Scan the rows, keeping the edges that cross the row sorted by x
+        size_t activeCount = 0;
+        size_t nextEdge = 0;
+        for (int32_t y = top; y < bottom; y++)
+        {
+            // drop the edges that ended above this row and add the ones that start on it
+            size_t kept = 0;
+            for (size_t i = 0; i < activeCount; i++)
+            {
+                if (active[i]->bottom > y)
+                    active[kept++] = active[i];
+            }
+            activeCount = kept;
+            while (nextEdge < edgeCount && edges[nextEdge].top <= y)
+                active[activeCount++] = &edges[nextEdge++];
+
+            // the order barely changes from one row to the next, so an insertion sort is close to linear
+            for (size_t i = 1; i < activeCount; i++)
+            {
+                polygon_edge_t* edge = active[i];
+                size_t j = i;
+                for (; j > 0 && active[j - 1]->x > edge->x; j--)
+                    active[j] = active[j - 1];
+                active[j] = edge;
+            }
+
+            // fill between the crossings where the fill rule says the row is inside
+            int32_t winding = 0;
+            int32_t startX = 0;
+            for (size_t i = 0; i < activeCount; i++)
             {
-                // Compute the x coordinate of the intersection, avoiding division by zero
-                int32_t x = points[i].x;
-                if (deltaY != 0) {
-                    x += (y - points[i].y) * (points[nextIndex].x - points[i].x) / deltaY;
+                bool wasInside = rule == FillEvenOdd ? (winding & 1) : winding != 0;
+                winding += active[i]->winding;
+                bool isInside = rule == FillEvenOdd ? (winding & 1) : winding != 0;
+
+                int32_t x = (int32_t)((active[i]->x + 0xffffffffLL) >> 32);
+                if (!wasInside && isInside)
+                    startX = x;
+                else if (wasInside && !isInside)
+                {
+                    int32_t left = imax(startX, area.left);
+                    int32_t right = imin(x, area.right);
+                    if (right > left)
+                        fillSpan(this->frameBuffer + left + y * this->config->width, color16, right - left);
                 }
-                if (x < xStart) xStart = x;
-                if (x > xEnd) xEnd = x;
             }
-        }
 
-        // Fill in the pixels between the start and end intersections
-        for (int32_t x = xStart; x < xEnd; x++)
-        {
-            // Verify that index is within the bounds of the framebuffer
-            this->frameBuffer[x + y * this->config->width] = color16;
+            for (size_t i = 0; i < activeCount; i++)
+                active[i]->x += active[i]->step;
         }
+
+        top = bottom;
     }
 }
\ No newline at end of file
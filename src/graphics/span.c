@@ -0,0 +1,322 @@
+#include "span.h"
+
+#ifdef SPAN_FILL_DMA
+#include <stdbool.h>
+#include "hardware/dma.h"
+#endif
+
+// Two pixels at a time, the buffer is written as 16 bit values everywhere else
+typedef uint32_t __attribute__((__may_alias__)) span_word_t;
+
+#ifdef SPAN_FILL_DMA
+static int spanChannel = -1;
+static uint32_t spanWord;
+
+/**
+ * @brief Fill words with the DMA, blocking until it is done
+ * @param words First word to fill, has to be word aligned
+ * @param word Value to fill with
+ * @param count Number of words
+ * @return true if the DMA did the fill, false if there is no free channel
+ * @note The channel is claimed on first use and kept, only use it from one core
+*/
+static bool fillWordsDMA(span_word_t* words, uint32_t word, size_t count)
+{
+    if (spanChannel < 0)
+    {
+        spanChannel = dma_claim_unused_channel(false);
+        if (spanChannel < 0)
+            return false;
+    }
+
+    // the DMA reads the same word over and over
+    spanWord = word;
+    dma_channel_config config = dma_channel_get_default_config(spanChannel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, true);
+    dma_channel_configure(spanChannel, &config, words, &spanWord, count, true);
+    dma_channel_wait_for_finish_blocking(spanChannel);
+    return true;
+}
+#endif
+
+/**
+ * @brief Fill a run of pixels with one color
+ * @param buffer First pixel to fill
+ * @param color Color to fill with
+ * @param length Number of pixels
+ * @note Writes two pixels per store, the ends are written one pixel at a time when they are not word aligned
+*/
+void fillSpan(uint16_t* buffer, uint16_t color, size_t length)
+{
+    if (length == 0)
+        return;
+
+    // align to a word
+    if ((uintptr_t)buffer & 2)
+    {
+        *buffer++ = color;
+        length--;
+    }
+
+    uint32_t word = color | ((uint32_t)color << 16);
+    span_word_t* words = (span_word_t*)buffer;
+    size_t count = length >> 1;
+
+#ifdef SPAN_FILL_DMA
+    if (length >= SPAN_DMA_MIN_PIXELS && fillWordsDMA(words, word, count))
+    {
+        words += count;
+        count = 0;
+    }
+#endif
+
+    // eight words per iteration, then what is left
+    while (count >= 8)
+    {
+        words[0] = word;
+        words[1] = word;
+        words[2] = word;
+        words[3] = word;
+        words[4] = word;
+        words[5] = word;
+        words[6] = word;
+        words[7] = word;
+        words += 8;
+        count -= 8;
+    }
+    while (count--)
+        *words++ = word;
+
+    if (length & 1)
+        *(uint16_t*)words = color;
+}
+
+/**
+ * @brief Fill a block of pixels with one color
+ * @param buffer First pixel of the block
+ * @param stride Number of pixels from the start of one row to the next
+ * @param color Color to fill with
+ * @param width Number of pixels per row
+ * @param height Number of rows
+ * @note Blocks spanning whole rows are filled as one span, blocks one pixel wide as a column
+*/
+void fillRect(uint16_t* buffer, size_t stride, uint16_t color, size_t width, size_t height)
+{
+    if (width == stride)
+    {
+        fillSpan(buffer, color, width * height);
+        return;
+    }
+
+    if (width == 1)
+    {
+        fillColumn(buffer, stride, color, height);
+        return;
+    }
+
+    for (size_t y = 0; y < height; y++)
+        fillSpan(buffer + y * stride, color, width);
+}
+
+/**
+ * @brief Fill a column of pixels with one color
+ * @param buffer Top pixel of the column
+ * @param stride Number of pixels from one row to the next
+ * @param color Color to fill with
+ * @param height Number of rows
+*/
+void fillColumn(uint16_t* buffer, size_t stride, uint16_t color, size_t height)
+{
+    // four rows per iteration, then what is left
+    while (height >= 4)
+    {
+        buffer[0] = color;
+        buffer[stride] = color;
+        buffer[2 * stride] = color;
+        buffer[3 * stride] = color;
+        buffer += 4 * stride;
+        height -= 4;
+    }
+    while (height--)
+    {
+        *buffer = color;
+        buffer += stride;
+    }
+}
+
+/**
+ * @brief Swap the two pixels of a word
+ * @param word Word to swap
+ * @return uint32_t Swapped word
+*/
+static inline uint32_t rotateWord(uint32_t word)
+{
+    return (word >> 16) | (word << 16);
+}
+
+/**
+ * @brief Blend two pixels over two others
+ * @param background Two pixels that are blended over
+ * @param even Spread new pixels of the word, multiplied by alpha
+ * @param odd Spread new pixels of the rotated word, multiplied by alpha
+ * @param beta SPAN_ALPHA_MAX minus alpha
+ * @return uint32_t The two blended pixels
+ * @note Masking the word gives red and blue of the first pixel and green of the second,
+ * masking the rotated word gives the rest, so two multiplies blend two pixels
+*/
+static inline uint32_t blendWord(uint32_t background, uint32_t even, uint32_t odd, uint32_t beta)
+{
+    uint32_t resultEven = ((even + (background & SPAN_SPREAD_MASK) * beta) >> 5) & SPAN_SPREAD_MASK;
+    uint32_t resultOdd = ((odd + (rotateWord(background) & SPAN_SPREAD_MASK) * beta) >> 5) & SPAN_SPREAD_MASK;
+    return resultEven | rotateWord(resultOdd);
+}
+
+/**
+ * @brief Blend one color over a run of pixels
+ * @param buffer First pixel to blend over
+ * @param color Color to blend on top
+ * @param alpha Alpha from 0 to SPAN_ALPHA_MAX
+ * @param length Number of pixels
+ * @note Blends two pixels per word, the ends are blended one pixel at a time when they are not word aligned
+*/
+void blendSpan(uint16_t* buffer, uint16_t color, uint32_t alpha, size_t length)
+{
+    if (alpha == 0 || length == 0)
+        return;
+
+    if (alpha >= SPAN_ALPHA_MAX)
+    {
+        fillSpan(buffer, color, length);
+        return;
+    }
+
+    // align to a word
+    if ((uintptr_t)buffer & 2)
+    {
+        *buffer = blendPixel(*buffer, color, alpha);
+        buffer++;
+        length--;
+    }
+
+    // both pixels of the word are the same color, so both halves share one product
+    uint32_t beta = SPAN_ALPHA_MAX - alpha;
+    uint32_t spread = ((color | ((uint32_t)color << 16)) & SPAN_SPREAD_MASK) * alpha;
+    span_word_t* words = (span_word_t*)buffer;
+    size_t count = length >> 1;
+
+    while (count >= 4)
+    {
+        words[0] = blendWord(words[0], spread, spread, beta);
+        words[1] = blendWord(words[1], spread, spread, beta);
+        words[2] = blendWord(words[2], spread, spread, beta);
+        words[3] = blendWord(words[3], spread, spread, beta);
+        words += 4;
+        count -= 4;
+    }
+    while (count--)
+    {
+        *words = blendWord(*words, spread, spread, beta);
+        words++;
+    }
+
+    if (length & 1)
+    {
+        uint16_t* last = (uint16_t*)words;
+        *last = blendPixel(*last, color, alpha);
+    }
+}
+
+/**
+ * @brief Blend one color over a block of pixels
+ * @param buffer First pixel of the block
+ * @param stride Number of pixels from the start of one row to the next
+ * @param color Color to blend on top
+ * @param alpha Alpha from 0 to SPAN_ALPHA_MAX
+ * @param width Number of pixels per row
+ * @param height Number of rows
+*/
+void blendRect(uint16_t* buffer, size_t stride, uint16_t color, uint32_t alpha, size_t width, size_t height)
+{
+    if (width == stride)
+    {
+        blendSpan(buffer, color, alpha, width * height);
+        return;
+    }
+
+    for (size_t y = 0; y < height; y++)
+        blendSpan(buffer + y * stride, color, alpha, width);
+}
+
+/**
+ * @brief Blend a run of pixels over another with one alpha
+ * @param buffer First pixel to blend over
+ * @param source First pixel to blend on top
+ * @param alpha Alpha from 0 to SPAN_ALPHA_MAX
+ * @param length Number of pixels
+ * @note Only the buffer has to be word aligned for the fast path, the source is read a pixel at a time
+*/
+void blendCopy(uint16_t* buffer, const uint16_t* source, uint32_t alpha, size_t length)
+{
+    if (alpha == 0 || length == 0)
+        return;
+
+    if (alpha >= SPAN_ALPHA_MAX)
+    {
+        for (size_t i = 0; i < length; i++)
+            buffer[i] = source[i];
+        return;
+    }
+
+    // align to a word
+    if ((uintptr_t)buffer & 2)
+    {
+        *buffer = blendPixel(*buffer, *source++, alpha);
+        buffer++;
+        length--;
+    }
+
+    uint32_t beta = SPAN_ALPHA_MAX - alpha;
+    span_word_t* words = (span_word_t*)buffer;
+    size_t count = length >> 1;
+
+    while (count--)
+    {
+        uint32_t color = source[0] | ((uint32_t)source[1] << 16);
+        uint32_t even = (color & SPAN_SPREAD_MASK) * alpha;
+        uint32_t odd = (rotateWord(color) & SPAN_SPREAD_MASK) * alpha;
+        *words = blendWord(*words, even, odd, beta);
+        words++;
+        source += 2;
+    }
+
+    if (length & 1)
+    {
+        uint16_t* last = (uint16_t*)words;
+        *last = blendPixel(*last, *source, alpha);
+    }
+}
+
+/**
+ * @brief Blend a run of pixels over another with an alpha for every pixel
+ * @param buffer First pixel to blend over
+ * @param source First pixel to blend on top
+ * @param mask Alpha of every pixel from 0 to 255
+ * @param length Number of pixels
+ * @note Transparent pixels are skipped and opaque pixels copied, which is most of a typical mask
+*/
+void blendCopyMasked(uint16_t* buffer, const uint16_t* source, const uint8_t* mask, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t alpha = mask[i];
+        if (alpha == 0)
+            continue;
+
+        if (alpha == 0xff)
+            buffer[i] = source[i];
+        else
+            buffer[i] = blendPixel(buffer[i], source[i], spanAlpha(alpha));
+    }
+}
\ No newline at end of file
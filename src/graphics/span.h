@@ -0,0 +1,59 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Define SPAN_FILL_DMA to hand long spans to a DMA channel instead of the CPU
+// Spans of at least this many pixels go to the DMA
+#ifndef SPAN_DMA_MIN_PIXELS
+#define SPAN_DMA_MIN_PIXELS 1024
+#endif
+
+extern void fillSpan(uint16_t* buffer, uint16_t color, size_t length);
+extern void fillRect(uint16_t* buffer, size_t stride, uint16_t color, size_t width, size_t height);
+extern void fillColumn(uint16_t* buffer, size_t stride, uint16_t color, size_t height);
+
+// Alpha of the blend functions, 0 keeps the background and SPAN_ALPHA_MAX is the new color
+#define SPAN_ALPHA_MAX 32
+// Spreads the channels of a pixel copied into both halves of a word so each
+// has 5 free bits above it, green sits in the upper half, red and blue in the lower
+#define SPAN_SPREAD_MASK 0x07e0f81f
+
+/**
+ * @brief Convert an 8 bit alpha to the alpha of the blend functions
+ * @param alpha Alpha from 0 to 255
+ * @return uint32_t Alpha from 0 to SPAN_ALPHA_MAX
+*/
+static inline uint32_t spanAlpha(uint8_t alpha)
+{
+    return ((uint32_t)alpha + 4) >> 3;
+}
+
+/**
+ * @brief Blend one pixel over another
+ * @param background Pixel that is blended over
+ * @param color Pixel that is blended on top
+ * @param alpha Alpha from 0 to SPAN_ALPHA_MAX
+ * @return uint16_t Blended pixel
+*/
+static inline uint16_t blendPixel(uint16_t background, uint16_t color, uint32_t alpha)
+{
+    uint32_t bg = (background | ((uint32_t)background << 16)) & SPAN_SPREAD_MASK;
+    uint32_t fg = (color | ((uint32_t)color << 16)) & SPAN_SPREAD_MASK;
+    uint32_t result = ((fg * alpha + bg * (SPAN_ALPHA_MAX - alpha)) >> 5) & SPAN_SPREAD_MASK;
+    return (uint16_t)(result | (result >> 16));
+}
+
+extern void blendSpan(uint16_t* buffer, uint16_t color, uint32_t alpha, size_t length);
+extern void blendRect(uint16_t* buffer, size_t stride, uint16_t color, uint32_t alpha, size_t width, size_t height);
+extern void blendCopy(uint16_t* buffer, const uint16_t* source, uint32_t alpha, size_t length);
+extern void blendCopyMasked(uint16_t* buffer, const uint16_t* source, const uint8_t* mask, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -1,5 +1,42 @@
 #include "graphics.hpp"
 
+// An edge of a filled triangle, x is in 32.32 fixed point so the
+// fill rule stays exact for edges taller than the display
+typedef struct
+{
+    int64_t x;
+    int64_t step;
+} triangle_edge_t;
+
+/**
+ * @brief Set up an edge to be walked down from a row
+ * @param from Upper end of the edge
+ * @param to Lower end of the edge, has to be below from
+ * @param y Row to start at
+ * @return triangle_edge_t The edge at the row
+ * @note The step is rounded down, so the walked x never ends up right of the real edge
+*/
+static triangle_edge_t triangleEdge(point from, point to, int32_t y)
+{
+    int64_t numerator = (int64_t)(to.x - from.x) << 32;
+    int32_t height = to.y - from.y;
+    int64_t step = numerator / height;
+    if (numerator % height != 0 && numerator < 0)
+        step--;
+
+    return { ((int64_t)from.x << 32) + step * (y - from.y), step };
+}
+
+/**
+ * @brief Round an edge up to the first pixel on or right of it
+ * @param x X in 32.32 fixed point
+ * @return int32_t The pixel
+*/
+static inline int32_t triangleCeil(int64_t x)
+{
+    return (int32_t)((x + 0xffffffffLL) >> 32);
+}
+
 /**
  * @brief Draw a triangle on the display
  * @param p1 First point
@@ -9,6 +46,8 @@
 */
 void graphics::drawTriangle(point p1, point p2, point p3, color color)
 {
+    PROFILE_SCOPE("drawTriangle", profileLength(p1, p2) + profileLength(p2, p3) + profileLength(p3, p1));
+
 	// Draw the three lines of the triangle
 	this->drawLine(p1, p2, color);
 	this->drawLine(p2, p3, color);
@@ -21,44 +60,63 @@ void graphics::drawTriangle(point p1, point p2, point p3, color color)
  * @param p2 Second point
  * @param p3 Third point
  * @param color color to draw in
+ * @note Pixels on the left and top edges are filled and pixels on the right and bottom edges are not,
+ * so triangles that share an edge neither overlap nor leave a gap
 */
 void graphics::drawFilledTriangle(point p1, point p2, point p3, color color)
 {
+    PROFILE_SCOPE("drawFilledTriangle", profileTriangleArea(p1, p2, p3));
+
     // calculate the bounding box of the triangle
     int32_t minX = imin(imin(p1.x, p2.x), p3.x);
     int32_t maxX = imax(imax(p1.x, p2.x), p3.x);
     int32_t minY = imin(imin(p1.y, p2.y), p3.y);
     int32_t maxY = imax(imax(p1.y, p2.y), p3.y);
+    this->markDamage(minX, minY, maxX, maxY);
+
+    clip_t area = this->getClipArea();
+    if (this->rejectClip(area, minX, minY, maxX, maxY))
+        return;
+
+    // sort the points from top to bottom
+    point swap;
+    if (p2.y < p1.y) { swap = p1; p1 = p2; p2 = swap; }
+    if (p3.y < p1.y) { swap = p1; p1 = p3; p3 = swap; }
+    if (p3.y < p2.y) { swap = p2; p2 = p3; p3 = swap; }
+
+    // the long edge from p1 to p3 is on the left when p2 is right of it, triangles without area are skipped
+    int32_t cross = (p2.x - p1.x) * (p3.y - p1.y) - (p2.y - p1.y) * (p3.x - p1.x);
+    if (cross == 0)
+        return;
+    bool longEdgeLeft = cross > 0;
 
     // convert the color to uint16_t
     uint16_t color16 = color.to16bit(this->config->inverseColors);
 
-    // iterate over each row within the bounding box
-    for (int32_t y = minY; y <= maxY; y++)
+    // walk the rows in the clip area, the upper half ends at p2 and the lower half goes on from it
+    int32_t y = imax(p1.y, area.top);
+    int32_t lastY = imin(p3.y, area.bottom);
+    triangle_edge_t longEdge = triangleEdge(p1, p3, y);
+    for (int32_t half = 0; half < 2; half++)
     {
-		// find the start x by interpolating between p1 and p2
-		int32_t divisor = (p2.y - p1.y) == 0 ? 1 : p2.y - p1.y;
-		int32_t startX = p1.x + (y - p1.y) * (p2.x - p1.x) / divisor;
-		// find the end x by interpolating between p2 and p3
-		divisor = (p3.y - p2.y) == 0 ? 1 : p3.y - p2.y;
-		int32_t endX = p2.x + (y - p2.y) * (p3.x - p2.x) / divisor;
+        point from = half == 0 ? p1 : p2;
+        point to = half == 0 ? p2 : p3;
+        int32_t end = imin(to.y, lastY);
+        if (y >= end)
+            continue;
 
-        // ensure startX <= endX
-        if (startX > endX)
+        triangle_edge_t shortEdge = triangleEdge(from, to, y);
+        triangle_edge_t* left = longEdgeLeft ? &longEdge : &shortEdge;
+        triangle_edge_t* right = longEdgeLeft ? &shortEdge : &longEdge;
+        for (; y < end; y++)
         {
-            int32_t temp = startX;
-            startX = endX;
-            endX = temp;
-        }
+            int32_t startX = imax(triangleCeil(left->x), area.left);
+            int32_t endX = imin(triangleCeil(right->x), area.right);
+            if (endX > startX)
+                fillSpan(this->frameBuffer + startX + y * this->config->width, color16, endX - startX);
 
-		// clamp the start and end points the screen
-        startX = imax(startX, 0);
-		endX = imin(endX, this->config->width);
-
-        // fill the pixels between the intersection points
-        for (int32_t x = startX; x <= endX; x++)
-        {
-            this->frameBuffer[x + y * this->config->width] = color16;
+            left->x += left->step;
+            right->x += right->step;
         }
     }
 }
\ No newline at end of file
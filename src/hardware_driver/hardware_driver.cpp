@@ -1,5 +1,7 @@
 #include "hardware_driver.hpp"
 
+hardware_driver* hardware_driver::drivers[NUM_DMA_CHANNELS] = { nullptr };
+
 /**
  * @brief Constructor for hardware_driver
  * @param config The struct containing the display configuration
@@ -10,6 +12,26 @@ hardware_driver::hardware_driver(display_config_t* config)
     this->interface = config->interface;
 }
 
+/**
+ * @brief Destructor for hardware_driver, releases the DMA channel
+*/
+hardware_driver::~hardware_driver()
+{
+    if (this->dma_tx < 0)
+        return;
+
+    this->waitIdle();
+    dma_channel_set_irq0_enabled(this->dma_tx, false);
+    drivers[this->dma_tx] = nullptr;
+    dma_channel_unclaim(this->dma_tx);
+
+    // the last driver takes the handler with it
+    for (hardware_driver* driver : drivers)
+        if (driver != nullptr)
+            return;
+    irq_remove_handler(DMA_IRQ_0, &hardware_driver::static_dma_irq_handler);
+}
+
 /**
  * @brief Initialize the hardware interface
 */
@@ -22,15 +44,24 @@ void hardware_driver::init()
             {
                 this->initSPIwPIO();
                 this->pioMode = true;
+                this->initDMA(&this->pio->txf[this->sm], pio_get_dreq(this->pio, this->sm, true));
             }
             else
             {
                 this->initSPI();
+                this->initDMA(&spi_get_hw(this->config->spi.spi_instance)->dr, spi_get_dreq(this->config->spi.spi_instance, true));
             }
             break;
 
         case display_interface_t::DISPLAY_8080:
             this->init8080();
+            // only a contiguous 16 bit bus can be driven by the state machine
+            if (this->parallel_interface_in_sequence && this->config->b8080.db_size == 16)
+            {
+                this->init8080wPIO();
+                this->pioMode = true;
+                this->initDMA(&this->pio->txf[this->sm], pio_get_dreq(this->pio, this->sm, true));
+            }
             break;
 
         default:
@@ -76,16 +107,20 @@ void hardware_driver::reset(uint32_t time_ms)
 */
 void hardware_driver::writeData(uint8_t command, const uint8_t* data, size_t length)
 {
+    PROFILE_BUS(1 + length);
+
     uint8_t mask = 0;
 
+    // the pixel stream has to leave the bus before the data/command pin is touched
+    this->waitIdle();
+
     switch (this->interface)
     {
         case display_interface_t::DISPLAY_SPI:
             if(this->pioMode)
             {
-                // We will to a bit of tomfoolery to solve the issue of switching between 8 and 16 bits
+                // commands are 8 bits, the pixel path switches back to 16 bits when it needs to
                 this->changeSPIbits(BITS_8);
-                pio_spi_wait_idle(this->pio, this->sm);
                 this->setSPIdataCommandPins(0, 0);
                 pio_spi_transmit_8(this->pio, this->sm, command);
                 if(length)
@@ -96,7 +131,6 @@ void hardware_driver::writeData(uint8_t command, const uint8_t* data, size_t len
                         pio_spi_transmit_8(this->pio, this->sm, *data++);
                 }
                 pio_spi_wait_idle(this->pio, this->sm);
-                this->changeSPIbits(BITS_16);
                 this->setSPIdataCommandPins(1, 1);
             }
             else
@@ -117,6 +151,12 @@ void hardware_driver::writeData(uint8_t command, const uint8_t* data, size_t len
             break;
 
         case display_interface_t::DISPLAY_8080:
+            if(this->pioMode)
+            {
+                this->write8080wPIO(command, data, length);
+                break;
+            }
+
             this->write8080(command, true, false);
 
             for (size_t i = 0; i < length; i++)
@@ -136,7 +176,10 @@ void hardware_driver::writeData(uint8_t command, const uint8_t* data, size_t len
 */
 void hardware_driver::setDataMode(uint8_t command)
 {
+    PROFILE_BUS(1);
+
     // printf("CMD: %x\n", command);
+    this->waitIdle();
 
     switch (this->interface)
     {
@@ -157,7 +200,10 @@ void hardware_driver::setDataMode(uint8_t command)
             break;
 
         case display_interface_t::DISPLAY_8080:
-            this->write8080(command, true, false);
+            if(this->pioMode)
+                this->write8080wPIO(command, nullptr, 0);
+            else
+                this->write8080(command, true, false);
             break;
 
         default:
@@ -167,17 +213,140 @@ void hardware_driver::setDataMode(uint8_t command)
 }
 
 /**
- * @brief Write data to the display
+ * @brief Send a table of commands as one batch
+ * @param commands Table of command, argument count, arguments and optional delay entries, see CMD_DELAY
+ * @param length Length of the table in bytes
+ * @note The bus is switched to 8 bits once for the whole table and is left in data mode,
+ * so a table ending in the memory write command can be followed by pixels right away
+*/
+void hardware_driver::writeCommands(const uint8_t* commands, size_t length)
+{
+    PROFILE_BUS(length);
+
+    // the pixel stream has to leave the bus before the data/command pin is touched
+    this->waitIdle();
+
+    if (this->interface == display_interface_t::DISPLAY_SPI)
+    {
+        if (this->pioMode)
+            this->changeSPIbits(BITS_8);
+        else
+            spi_set_format(this->config->spi.spi_instance, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    }
+
+    // delays are only waited out once the next command is about to go out
+    uint32_t delay = 0;
+    size_t i = 0;
+    while (i + 1 < length)
+    {
+        uint8_t command = commands[i++];
+        uint8_t count = commands[i++];
+        size_t arguments = count & CMD_ARGS_MASK;
+        if (arguments > length - i)
+            arguments = length - i;
+        const uint8_t* data = &commands[i];
+        i += arguments;
+
+        if (delay)
+        {
+            sleep_ms(delay);
+            delay = 0;
+        }
+
+        switch (this->interface)
+        {
+            case display_interface_t::DISPLAY_SPI:
+                if (this->pioMode)
+                {
+                    this->setSPIdataCommandPins(0, 0);
+                    pio_spi_transmit_8(this->pio, this->sm, command);
+                    pio_spi_wait_idle(this->pio, this->sm);
+                    this->setSPIdataCommandPins(1, 0);
+                    for (size_t j = 0; j < arguments; j++)
+                        pio_spi_transmit_8(this->pio, this->sm, data[j]);
+                    pio_spi_wait_idle(this->pio, this->sm);
+                }
+                else
+                {
+                    gpio_put(this->config->spi.dc, 0);
+                    spi_write_blocking(this->config->spi.spi_instance, &command, 1);
+                    gpio_put(this->config->spi.dc, 1);
+                    if (arguments)
+                        spi_write_blocking(this->config->spi.spi_instance, data, arguments);
+                }
+                break;
+
+            case display_interface_t::DISPLAY_8080:
+                if (this->pioMode)
+                {
+                    this->write8080wPIO(command, data, arguments);
+                    break;
+                }
+
+                this->write8080(command, true, false);
+                for (size_t j = 0; j < arguments; j++)
+                    this->write8080(data[j], false, false);
+                break;
+
+            default:
+                printf("Unknown display interface: %d (Command Function)\n", this->interface);
+                return;
+        }
+
+        if ((count & CMD_DELAY) && i < length)
+            delay += commands[i++];
+    }
+
+    if (delay)
+        sleep_ms(delay);
+
+    // the pixel path expects the hardware spi in 16 bit mode
+    if (this->interface == display_interface_t::DISPLAY_SPI && !this->pioMode)
+        spi_set_format(this->config->spi.spi_instance, 16, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+}
+
+/**
+ * @brief Write pixels to the display, blocking until they are on the wire
  * @param data The data to send
  * @param length The length of the data
- * @return bytes written on success, -1 on failure
 */
 void hardware_driver::writePixels(const uint16_t* data, size_t length)
 {
+    PROFILE_BUS(0);
+
+    this->writePixelsAsync(data, length);
+    this->waitIdle();
+}
+
+/**
+ * @brief Start streaming pixels to the display
+ * @param data The data to send
+ * @param length The length of the data
+ * @note The buffer is read by DMA after this returns, do not touch it until isBusy() returns false
+*/
+void hardware_driver::writePixelsAsync(const uint16_t* data, size_t length)
+{
+    PROFILE_BUS(length * 2);
+
+    if (length == 0)
+        return;
+
     switch(this->interface)
     {
         case display_interface_t::DISPLAY_SPI:
-            if(this->pioMode)
+            // only one transfer can be queued on the channel at a time
+            while (this->dmaBusy)
+                tight_loop_contents();
+
+            if (this->pioMode)
+                this->changeSPIbits(BITS_16);
+
+            if (this->dma_tx >= 0)
+            {
+                this->dmaBusy = true;
+                dma_channel_transfer_from_buffer_now(this->dma_tx, data, length);
+            }
+            else if(this->pioMode)
             {
                 while(length--)
                     pio_spi_transmit_16(this->pio, this->sm, *data++);
@@ -190,6 +359,16 @@ void hardware_driver::writePixels(const uint16_t* data, size_t length)
             break;
 
         case display_interface_t::DISPLAY_8080:
+            if (this->pioMode && this->dma_tx >= 0)
+            {
+                while (this->dmaBusy)
+                    tight_loop_contents();
+
+                this->dmaBusy = true;
+                dma_channel_transfer_from_buffer_now(this->dma_tx, data, length);
+                break;
+            }
+
             for (size_t i = 0; i < length; i++)
                 this->write8080(data[i], false, true);
             break;
@@ -201,6 +380,105 @@ void hardware_driver::writePixels(const uint16_t* data, size_t length)
     // printf("FINISHED WRITING %d PIXELS\n", length);
 }
 
+/**
+ * @brief Write a block of pixels out of a larger buffer, blocking until they are on the wire
+ * @param data The first pixel of the block
+ * @param width The number of pixels per row
+ * @param height The number of rows
+ * @param stride The number of pixels from the start of one row to the next
+*/
+void hardware_driver::writePixelsStrided(const uint16_t* data, size_t width, size_t height, size_t stride)
+{
+    PROFILE_BUS(0);
+
+    this->writePixelsStridedAsync(data, width, height, stride);
+    this->waitIdle();
+}
+
+/**
+ * @brief Start streaming a block of pixels out of a larger buffer
+ * @param data The first pixel of the block
+ * @param width The number of pixels per row
+ * @param height The number of rows
+ * @param stride The number of pixels from the start of one row to the next
+ * @note The DMA interrupt re-arms the channel for every row, so the rows go out as one transaction
+*/
+void hardware_driver::writePixelsStridedAsync(const uint16_t* data, size_t width, size_t height, size_t stride)
+{
+    PROFILE_BUS(0);
+
+    if (width == 0 || height == 0)
+        return;
+
+    // contiguous rows are a single transfer
+    if (width == stride || height == 1)
+    {
+        this->writePixelsAsync(data, width * height);
+        return;
+    }
+
+    if (this->dma_tx < 0 || (this->interface == display_interface_t::DISPLAY_8080 && !this->pioMode))
+    {
+        for (size_t y = 0; y < height; y++)
+            this->writePixelsAsync(data + y * stride, width);
+        return;
+    }
+
+    // the previous transfer still owns the interrupt
+    while (this->dmaBusy)
+        tight_loop_contents();
+
+    this->stridedWidth = width;
+    this->stridedStride = stride;
+    this->stridedData = data;
+    this->stridedRows = height - 1;
+    PROFILE_BUS_BYTES((height - 1) * width * 2);
+    this->writePixelsAsync(data, width);
+}
+
+/**
+ * @brief Check if a pixel transfer is still in progress
+ * @return true if the DMA or the bus is still busy
+*/
+bool hardware_driver::isBusy(void)
+{
+    if (this->dmaBusy)
+        return true;
+
+    if (this->pioMode)
+        return !pio_sm_is_tx_fifo_empty(this->pio, this->sm);
+
+    if (this->interface != display_interface_t::DISPLAY_SPI)
+        return false;
+
+    return spi_is_busy(this->config->spi.spi_instance);
+}
+
+/**
+ * @brief Block until the pending pixel transfer has left the bus
+*/
+void hardware_driver::waitIdle(void)
+{
+    PROFILE_BUS(0);
+
+    while (this->dmaBusy)
+        tight_loop_contents();
+
+    this->waitBusIdle();
+}
+
+/**
+ * @brief Set a function to call when a pixel transfer has finished
+ * @param callback Function to call, nullptr to disable
+ * @param context Pointer handed back to the callback
+ * @note The callback runs in interrupt context, keep it short
+*/
+void hardware_driver::setCompletionCallback(hardware_driver_callback_t callback, void* context)
+{
+    this->callbackContext = context;
+    this->callback = callback;
+}
+
 /**
  * @private
  * @brief Initialize the hw bus
@@ -233,6 +511,7 @@ void hardware_driver::initSPIwPIO(void)
     this->clkdiv = (float)clock_get_hz(clk_sys) / (float)this->config->spi.baudrate;
     pio_spi_init(this->pio, this->sm, this->offset, this->config->spi.sda, 
         this->config->spi.scl, this->clkdiv, (int)BITS_8);
+    this->spiBits = BITS_8;
 
     // set the pins to hw function
     gpio_init(this->config->spi.cs);
@@ -334,6 +613,104 @@ void hardware_driver::init8080(void)
     }
 }
 
+/**
+ * @private
+ * @brief Claim a DMA channel to stream pixels into the TX FIFO
+ * @param writeAddress The FIFO register to write to
+ * @param dreq The data request signal that paces the transfer
+*/
+void hardware_driver::initDMA(volatile void* writeAddress, uint32_t dreq)
+{
+    this->dma_tx = dma_claim_unused_channel(true);
+    this->dma_config = dma_channel_get_default_config(this->dma_tx);
+    channel_config_set_transfer_data_size(&this->dma_config, DMA_SIZE_16);
+    channel_config_set_read_increment(&this->dma_config, true);
+    channel_config_set_write_increment(&this->dma_config, false);
+    channel_config_set_dreq(&this->dma_config, dreq);
+    dma_channel_configure(this->dma_tx, &this->dma_config, writeAddress, nullptr, 0, false);
+
+    // let the interrupt tell us when the transfer is done, the first driver adds the handler
+    bool first = true;
+    for (hardware_driver* driver : drivers)
+        if (driver != nullptr)
+            first = false;
+    drivers[this->dma_tx] = this;
+    dma_channel_set_irq0_enabled(this->dma_tx, true);
+    if (first)
+        irq_add_shared_handler(DMA_IRQ_0, &hardware_driver::static_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+/**
+ * @private
+ * @brief Hand the DMA interrupt to every driver whose channel has fired
+*/
+void hardware_driver::static_dma_irq_handler(void)
+{
+    for (hardware_driver* driver : drivers)
+        if (driver != nullptr)
+            driver->dmaIrqHandler();
+}
+
+/**
+ * @private
+ * @brief Handle the DMA completion interrupt
+*/
+void hardware_driver::dmaIrqHandler(void)
+{
+    // the interrupt is shared, make sure it is ours
+    if (this->dma_tx < 0 || !dma_channel_get_irq0_status(this->dma_tx))
+        return;
+
+    dma_channel_acknowledge_irq0(this->dma_tx);
+
+    // strided transfers continue with the next row
+    if (this->stridedRows > 0)
+    {
+        this->stridedRows = this->stridedRows - 1;
+        this->stridedData = this->stridedData + this->stridedStride;
+        dma_channel_transfer_from_buffer_now(this->dma_tx, this->stridedData, this->stridedWidth);
+        return;
+    }
+
+    this->dmaBusy = false;
+
+    if (this->callback != nullptr)
+        this->callback(this->callbackContext);
+}
+
+/**
+ * @private
+ * @brief Wait for the last bits in the TX FIFO to be shifted out
+*/
+void hardware_driver::waitBusIdle(void)
+{
+    if (this->interface == display_interface_t::DISPLAY_8080)
+    {
+        if (this->pioMode)
+            pio_8080_wait_idle(this->pio, this->sm);
+        return;
+    }
+
+    if (this->interface != display_interface_t::DISPLAY_SPI)
+        return;
+
+    if (this->pioMode)
+    {
+        pio_spi_wait_idle(this->pio, this->sm);
+        return;
+    }
+
+    spi_inst_t* spi = this->config->spi.spi_instance;
+    while (spi_is_busy(spi))
+        tight_loop_contents();
+
+    // the DMA does not drain the RX FIFO, throw away what was clocked in and clear the overrun
+    while (spi_is_readable(spi))
+        (void)spi_get_hw(spi)->dr;
+    spi_get_hw(spi)->icr = SPI_SSPICR_RORIC_BITS;
+}
+
 /**
  * @private
  * @brief Change the hw bit length
@@ -341,16 +718,73 @@ void hardware_driver::init8080(void)
 */
 void hardware_driver::changeSPIbits(spi_bit_length_t bits)
 {
-    // Stop the state machine
-    pio_sm_set_enabled(this->pio, this->sm, false);
-    // Remove the program
-    pio_remove_program(this->pio, &pio_spi_program, this->offset);
-    
-    // Re-add the program
-    this->offset = pio_add_program(this->pio, &pio_spi_program);
-    // Re-initialize the state machine
-    pio_spi_init(this->pio, this->sm, this->offset, this->config->spi.sda, 
-        this->config->spi.scl, this->clkdiv, (int)bits);
+    if (bits == this->spiBits)
+        return;
+
+    // the words still in the FIFO were queued for the old length
+    pio_spi_wait_idle(this->pio, this->sm);
+    pio_spi_set_bits(this->pio, this->sm, (int)bits);
+    this->spiBits = bits;
+}
+
+/**
+ * @private
+ * @brief Initialize the 8080 interface with PIO
+ * @note The data pins and WR are handed over to the state machine
+*/
+void hardware_driver::init8080wPIO(void)
+{
+    this->pio = pio0;
+    this->sm = pio_claim_unused_sm(this->pio, true);
+    this->offset = pio_add_program(this->pio, &pio_8080_program);
+
+    // a write cycle is two state machine cycles
+    float cycles = (float)clock_get_hz(clk_sys) * (float)PIO_8080_WRITE_CYCLE_NS / 1e9f;
+    this->clkdiv = cycles / 2.0f;
+    if (this->clkdiv < 1.0f)
+        this->clkdiv = 1.0f;
+
+    pio_8080_init(this->pio, this->sm, this->offset, this->parallel_interface_min_pin, 
+        this->config->b8080.wrx, this->clkdiv);
+}
+
+/**
+ * @private
+ * @brief Write a command and its parameters through the 8080 state machine
+ * @param command The command to send
+ * @param data The parameters to send
+ * @param length The number of parameters
+*/
+void hardware_driver::write8080wPIO(uint8_t command, const uint8_t* data, size_t length)
+{
+    // the data/command pin is not part of the state machine, so it can only change when it is idle
+    pio_8080_wait_idle(this->pio, this->sm);
+    gpio_put(this->config->b8080.dcx, 0);
+    pio_8080_put(this->pio, this->sm, this->parallelByte(command));
+    pio_8080_wait_idle(this->pio, this->sm);
+    gpio_put(this->config->b8080.dcx, 1);
+
+    for (size_t i = 0; i < length; i++)
+        pio_8080_put(this->pio, this->sm, this->parallelByte(data[i]));
+}
+
+/**
+ * @private
+ * @brief Map a command or parameter byte onto the data pins
+ * @param data The byte to map
+ * @return The value to put on the pins, starting at the lowest data pin
+*/
+uint32_t hardware_driver::parallelByte(uint8_t data)
+{
+    if (!this->parallel_interface_reverse_order)
+        return data;
+
+    // the byte has to end up on DB0-DB7, which are the upper pins when the order is reversed
+    uint32_t _data = data;
+    _data = ((_data & 0xaa) >> 1) | ((_data & 0x55) << 1);
+    _data = ((_data & 0xcc) >> 2) | ((_data & 0x33) << 2);
+    _data = ((_data >> 4) | (_data << 4)) & 0xff;
+    return _data << 8;
 }
 
 /**
@@ -366,15 +800,7 @@ void hardware_driver::write8080(uint32_t data, bool command, bool bit16)
 
     if (this->parallel_interface_in_sequence)
     {
-        uint32_t _data = data;
-
-        if (this->parallel_interface_reverse_order && !bit16)
-        {
-            _data = ((_data & 0xaa) >> 1) | ((_data & 0x55) << 1);
-            _data = ((_data & 0xcc) >> 2) | ((_data & 0x33) << 2);
-            _data = (_data >> 4) | (_data << 4);
-            _data <<= 8;
-        }
+        uint32_t _data = bit16 ? data : this->parallelByte(data);
 
         uint32_t mask = _data << this->parallel_interface_min_pin;
         gpio_put_masked(this->parallel_interface_mask, mask);
@@ -399,10 +825,9 @@ void hardware_driver::write8080(uint32_t data, bool command, bool bit16)
 */
 inline void hardware_driver::setSPIdataCommandPins(bool dc, bool cs)
 {
-    sleep_us(1);
+    // callers wait for the state machine to go idle, so the pins can change right away
     gpio_put_masked((1u << this->config->spi.dc) | (1u << this->config->spi.cs), 
         !!dc << this->config->spi.dc | !!cs << this->config->spi.cs);
-    sleep_us(1);
 }
 
 /**
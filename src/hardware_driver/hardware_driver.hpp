@@ -5,10 +5,16 @@
 #include "pico/stdlib.h"
 #include "hardware/spi.h"
 #include "hardware/dma.h"
+#include "hardware/irq.h"
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
 #include "pio_spi.pio.h"
+#include "pio_8080.pio.h"
 #include "display_struct.h"
+#include "profiler.hpp"
+
+// Shortest write cycle the 8080 displays accept, used to pace the PIO bus
+#define PIO_8080_WRITE_CYCLE_NS 66
 
 typedef enum
 {
@@ -16,6 +22,14 @@ typedef enum
     BITS_16 = 16
 }  spi_bit_length_t;
 
+// Command tables are a list of: command, argument count, arguments...
+// With CMD_DELAY or'ed into the count, a delay in ms follows the arguments
+#define CMD_DELAY 0x80
+#define CMD_ARGS_MASK 0x7f
+
+// Called from the DMA interrupt once a pixel transfer has left the buffer
+typedef void (*hardware_driver_callback_t)(void* context);
+
 typedef struct pio_spi_inst 
 {
     PIO pio;
@@ -27,28 +41,51 @@ class hardware_driver
 {
 public:
     hardware_driver(display_config_t* config);
+    ~hardware_driver();
     void init(void);
     void reset(uint32_t time_ms);
 
     void writeData(uint8_t command, const uint8_t* data, size_t length);
     void setDataMode(uint8_t command);
+    void writeCommands(const uint8_t* commands, size_t length);
     void writePixels(const uint16_t* data, size_t length);
+    void writePixelsAsync(const uint16_t* data, size_t length);
+    void writePixelsStrided(const uint16_t* data, size_t width, size_t height, size_t stride);
+    void writePixelsStridedAsync(const uint16_t* data, size_t width, size_t height, size_t stride);
+
+    bool isBusy(void);
+    void waitIdle(void);
+    void setCompletionCallback(hardware_driver_callback_t callback, void* context = nullptr);
 
 private:
     // general stuff
     display_config_t* config;
     display_interface_t interface;
-    bool pioMode = false;   // hw mode only
+    bool pioMode = false;   // spi or 8080 driven by pio
 
     // dma stuff
-    uint32_t dma_tx;
+    int32_t dma_tx = -1;
     dma_channel_config dma_config;
+    volatile bool dmaBusy = false;
+    hardware_driver_callback_t callback = nullptr;
+    void* callbackContext = nullptr;
+
+    // rows still to be sent by the interrupt for a strided transfer
+    const uint16_t* volatile stridedData = nullptr;
+    volatile size_t stridedRows = 0;
+    size_t stridedWidth = 0;
+    size_t stridedStride = 0;
+
+    // every driver that owns a DMA channel, they all share DMA_IRQ_0
+    static hardware_driver* drivers[NUM_DMA_CHANNELS];
+    static void static_dma_irq_handler(void);
 
     // pio stuff
     PIO pio;
     uint32_t sm;
     uint32_t offset;
     float clkdiv;
+    spi_bit_length_t spiBits = BITS_8;
 
     // general
     bool enabled = false;
@@ -62,8 +99,14 @@ private:
     void initSPI(void);
     void initSPIwPIO(void);
     void init8080(void);
+    void init8080wPIO(void);
+    void initDMA(volatile void* writeAddress, uint32_t dreq);
+    void dmaIrqHandler(void);
+    void waitBusIdle(void);
     void changeSPIbits(spi_bit_length_t bits);
     void write8080(uint32_t data, bool command, bool bit16);
+    void write8080wPIO(uint8_t command, const uint8_t* data, size_t length);
+    uint32_t parallelByte(uint8_t data);
     inline void setSPIdataCommandPins(bool dc, bool cs);
     bool isSequential(uint32_t* arr, size_t size);
     uint16_t flipBits(uint16_t value);
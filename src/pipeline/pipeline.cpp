@@ -0,0 +1,242 @@
+#include "pipeline.hpp"
+
+pipeline* pipeline::instance = nullptr;
+
+/**
+ * @brief Construct a new pipeline
+ * @param disp Display the jobs are flushed to
+ * @note Once started core 1 owns the display bus, core 0 must not send anything itself
+*/
+pipeline::pipeline(display* disp)
+{
+    this->disp = disp;
+}
+
+/**
+ * @brief Launch core 1 and start draining the job queue
+ * @note Only one pipeline can run at a time, the DMA interrupt stays on the core that initialized the hardware driver
+ * @note Jobs submitted before start() or after stop() are sent on the calling core before the submit returns
+*/
+void pipeline::start(void)
+{
+    if (this->isRunning())
+        return;
+
+    // the previous frame might still be on the wire
+    this->disp->waitIdle();
+
+    pipeline::instance = this;
+    this->running.store(true, std::memory_order_release);
+    multicore_launch_core1(pipeline::core1Entry);
+}
+
+/**
+ * @brief Finish every queued job and stop core 1
+*/
+void pipeline::stop(void)
+{
+    if (!this->isRunning())
+        return;
+
+    this->waitIdle();
+    this->running.store(false, std::memory_order_release);
+    multicore_reset_core1();
+    pipeline::instance = nullptr;
+}
+
+/**
+ * @brief Queue a full frame
+ * @param buffer Buffer of width * height pixels
+ * @return uint32_t Job id, the buffer must stay untouched until the job is done
+*/
+uint32_t pipeline::submitFrame(const uint16_t* buffer)
+{
+    pipeline_job_t job = {
+        .type = PipelineFrame,
+        .id = 0,
+        .data = buffer,
+        .x0 = 0,
+        .y0 = 0,
+        .x1 = (int32_t)this->disp->getWidth() - 1,
+        .y1 = (int32_t)this->disp->getHeight() - 1,
+    };
+    return this->submit(job);
+}
+
+/**
+ * @brief Queue part of a frame
+ * @param buffer Buffer of width * height pixels
+ * @param area Area to send, the edges are included
+ * @return uint32_t Job id, the area must stay untouched until the job is done
+*/
+uint32_t pipeline::submitRect(const uint16_t* buffer, rect area)
+{
+    pipeline_job_t job = {
+        .type = PipelineRect,
+        .id = 0,
+        .data = buffer,
+        .x0 = imax(area.left(), 0),
+        .y0 = imax(area.top(), 0),
+        .x1 = imin(area.right(), (int32_t)this->disp->getWidth() - 1),
+        .y1 = imin(area.bottom(), (int32_t)this->disp->getHeight() - 1),
+    };
+    return this->submit(job);
+}
+
+/**
+ * @brief Queue a strip of full width rows
+ * @param strip Buffer of width * rows pixels
+ * @param top First display row held by the strip
+ * @param rows Number of rows in the strip
+ * @return uint32_t Job id, the strip must stay untouched until the job is done
+*/
+uint32_t pipeline::submitStrip(const uint16_t* strip, uint32_t top, uint32_t rows)
+{
+    pipeline_job_t job = {
+        .type = PipelineStrip,
+        .id = 0,
+        .data = strip,
+        .x0 = 0,
+        .y0 = (int32_t)top,
+        .x1 = (int32_t)this->disp->getWidth() - 1,
+        .y1 = imin((int32_t)(top + rows), (int32_t)this->disp->getHeight()) - 1,
+    };
+    return this->submit(job);
+}
+
+/**
+ * @brief Check if a job has been sent
+ * @param id Job id returned when the job was queued
+ * @return bool True once the buffer of the job can be reused
+ * @note Jobs finish in the order they were queued
+*/
+bool pipeline::isDone(uint32_t id)
+{
+    this->collect();
+    return (int32_t)(this->completed - id) >= 0;
+}
+
+/**
+ * @brief Wait until a job has been sent
+ * @param id Job id returned when the job was queued
+*/
+void pipeline::waitFor(uint32_t id)
+{
+    while (!this->isDone(id))
+        tight_loop_contents();
+}
+
+/**
+ * @brief Wait until every queued job has been sent
+*/
+void pipeline::waitIdle(void)
+{
+    this->waitFor(this->nextId - 1);
+}
+
+/**
+ * @private
+ * @brief Entry point of core 1
+*/
+void pipeline::core1Entry(void)
+{
+    pipeline::instance->run();
+}
+
+/**
+ * @private
+ * @brief Job loop on core 1, every finished job id is pushed back through the FIFO
+*/
+void pipeline::run(void)
+{
+    while (this->running.load(std::memory_order_acquire))
+    {
+        uint32_t tail = this->tail.load(std::memory_order_relaxed);
+        if (tail == this->head.load(std::memory_order_acquire))
+        {
+            tight_loop_contents();
+            continue;
+        }
+
+        pipeline_job_t* job = &this->jobs[tail & (PIPELINE_QUEUE_SIZE - 1)];
+        this->execute(job);
+        uint32_t id = job->id;
+
+        // hand the slot back before reporting, core 0 may be waiting for space
+        this->tail.store(tail + 1, std::memory_order_release);
+        multicore_fifo_push_blocking(id);
+    }
+}
+
+/**
+ * @private
+ * @brief Send a single job, returns once the buffer is free again
+ * @param job Job to send
+*/
+void pipeline::execute(pipeline_job_t* job)
+{
+    uint32_t width = this->disp->getWidth();
+    uint32_t jobWidth = job->x1 - job->x0 + 1;
+    uint32_t jobHeight = job->y1 - job->y0 + 1;
+
+    if (job->x1 < job->x0 || job->y1 < job->y0)
+        return;
+
+    switch (job->type)
+    {
+    case PipelineFrame:
+        this->disp->setCursor({ 0, 0 });
+        this->disp->writePixels(job->data, width * jobHeight);
+        break;
+    case PipelineRect:
+        this->disp->setWindow({ job->x0, job->y0 }, { job->x1, job->y1 });
+        this->disp->writePixelsStrided(&job->data[job->x0 + job->y0 * width], jobWidth, jobHeight, width);
+        break;
+    case PipelineStrip:
+        this->disp->setWindow({ job->x0, job->y0 }, { job->x1, job->y1 });
+        this->disp->writePixels(job->data, width * jobHeight);
+        break;
+    }
+}
+
+/**
+ * @private
+ * @brief Put a job in the queue, waits while the queue is full
+ * @param job Job to queue
+ * @return uint32_t Id given to the job
+ * @note Without core 1 to drain the queue the job is sent right away on the calling core
+*/
+uint32_t pipeline::submit(pipeline_job_t job)
+{
+    if (!this->isRunning())
+    {
+        job.id = this->nextId++;
+        this->execute(&job);
+        this->completed = job.id;
+        return job.id;
+    }
+
+    uint32_t head = this->head.load(std::memory_order_relaxed);
+
+    // keep draining the FIFO, core 1 blocks on it when nobody reads it
+    while (head - this->tail.load(std::memory_order_acquire) >= PIPELINE_QUEUE_SIZE)
+    {
+        this->collect();
+        tight_loop_contents();
+    }
+
+    job.id = this->nextId++;
+    this->jobs[head & (PIPELINE_QUEUE_SIZE - 1)] = job;
+    this->head.store(head + 1, std::memory_order_release);
+    return job.id;
+}
+
+/**
+ * @private
+ * @brief Read the finished job ids out of the FIFO
+*/
+void pipeline::collect(void)
+{
+    while (multicore_fifo_rvalid())
+        this->completed = multicore_fifo_pop_blocking();
+}
\ No newline at end of file
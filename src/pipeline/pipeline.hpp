@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "display.hpp"
+#include "shapes.hpp"
+
+// Number of flush jobs that can be queued for core 1, has to be a power of two
+#ifndef PIPELINE_QUEUE_SIZE
+#define PIPELINE_QUEUE_SIZE 8
+#endif
+
+typedef enum
+{
+    PipelineFrame,  // whole frame out of a full size buffer
+    PipelineRect,   // part of a full size buffer
+    PipelineStrip,  // full width rows out of a strip buffer
+} pipeline_job_type_t;
+
+typedef struct
+{
+    pipeline_job_type_t type;
+    uint32_t id;
+    const uint16_t* data;
+    int32_t x0;
+    int32_t y0;
+    int32_t x1;     // included in the job
+    int32_t y1;     // included in the job
+} pipeline_job_t;
+
+class pipeline
+{
+public:
+    pipeline(display* disp);
+
+    void start(void);
+    void stop(void);
+    bool isRunning(void) { return this->running.load(std::memory_order_acquire); }
+
+    uint32_t submitFrame(const uint16_t* buffer);
+    uint32_t submitRect(const uint16_t* buffer, rect area);
+    uint32_t submitStrip(const uint16_t* strip, uint32_t top, uint32_t rows);
+
+    bool isDone(uint32_t id);
+    void waitFor(uint32_t id);
+    void waitIdle(void);
+    uint32_t getCompleted(void) { return this->completed; }
+
+private:
+    display* disp;
+
+    // single producer (core 0), single consumer (core 1) ring of jobs
+    pipeline_job_t jobs[PIPELINE_QUEUE_SIZE];
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};
+    std::atomic<bool> running{false};
+
+    // only touched by core 0
+    uint32_t nextId = 1;
+    uint32_t completed = 0;
+
+    static pipeline* instance;
+    static void core1Entry(void);
+    void run(void);
+    void execute(pipeline_job_t* job);
+    uint32_t submit(pipeline_job_t job);
+    void collect(void);
+};
\ No newline at end of file
@@ -14,6 +14,33 @@ printer::printer(uint16_t* frameBuffer, display_config_t* config)
     this->characterBuffer[0] = '\0';
 }
 
+/**
+ * @brief Point the object at a whole frame buffer
+ * @param frameBuffer Buffer of width * height pixels
+ * @note Removes the band set by setBand()
+*/
+void printer::setFrameBuffer(uint16_t* frameBuffer)
+{
+    this->frameBuffer = frameBuffer;
+    this->bandStart = 0;
+    this->bandEnd = UINT32_MAX;
+}
+
+/**
+ * @brief Draw into a strip of rows instead of a whole frame buffer
+ * @param buffer Buffer of width * rows pixels
+ * @param top First display row held by the buffer
+ * @param rows Number of rows in the buffer
+ * @note Text outside the band is clipped, the cursor still moves as if it was drawn
+*/
+void printer::setBand(uint16_t* buffer, int32_t top, uint32_t rows)
+{
+    // offset the buffer so display coordinates index straight into the strip
+    this->frameBuffer = buffer - top * (int32_t)this->config->width;
+    this->bandStart = top * this->config->width;
+    this->bandEnd = (top + rows) * this->config->width;
+}
+
 /**
  * @brief Set the color to use
  * @param color color to use
@@ -134,6 +161,8 @@ void printer::center(Alignment_t alignment)
 */
 void printer::print()
 {
+    PROFILE_SCOPE("print", this->getStringWidth() * this->getStringHeight());
+
     // loop through each character in the string
     for (int32_t i = 0; i < this->charactersInBuffer; i++)
     {
@@ -218,6 +247,8 @@ void printer::print(const char* format, ...)
 	this->charactersInBuffer = vsnprintf(this->characterBuffer, CHARACTER_BUFFER_SIZE - 1, format, args);
 	va_end(args);
 
+	PROFILE_SCOPE("print", this->getStringWidth() * this->getStringHeight());
+
 	// loop through each character in the string
     for (int32_t i = 0; i < this->charactersInBuffer; i++)
     {
@@ -247,8 +278,8 @@ void printer::drawAscii(const char character)
     
     // get the bitmap data
     const uint32_t* bitmap = this->font->bitmap;
-    // get the character
-    FontCharacter charData = this->font->characters[character - 0x20];
+    // get the character, control characters have no glyph and use the size of a space
+    FontCharacter charData = this->font->characters[character < 0x20 ? 0 : character - 0x20];
 
     // if the bitmap is a null pointer or overflows the frame buffer, return 0
     if (!((bitmap != nullptr) && ((charData.width * charData.height) < (this->config->width * this->config->height))))
@@ -300,6 +331,20 @@ void printer::drawAscii(const char character)
 
     // move the cursor by the y offset
     bufferPosition += charData.yOffset * this->config->width;
+
+    if (this->damage != nullptr)
+    {
+        int32_t x = bufferPosition % this->config->width;
+        int32_t y = bufferPosition / this->config->width;
+        this->damage->add(x, y, x + charData.width - 1, y + charData.height - 1);
+    }
+    // characters outside of the band only move the cursor
+    if (bufferPosition >= this->bandEnd || bufferPosition + charData.height * this->config->width <= this->bandStart)
+    {
+        this->cursor += rowSize;
+        return;
+    }
+
     // keep track of the current row position
     uint32_t rowPosition = 0;
 
@@ -316,7 +361,9 @@ void printer::drawAscii(const char character)
         for (int32_t i = 0; i < data; i++)
         {
             // every other distance should be drawn, the first distance is always the number of pixels to skip
-            if (j & 0x1) this->frameBuffer[rowPosition + bufferPosition] = this->color_val;
+            uint32_t index = rowPosition + bufferPosition;
+            if ((j & 0x1) && index >= this->bandStart && index < this->bandEnd) 
+                this->frameBuffer[index] = this->color_val;
 
             // increment the row position
             rowPosition++;
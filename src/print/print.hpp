@@ -4,6 +4,8 @@
 #include "display_struct.h"
 #include "shapes.hpp"
 #include "fontstruct.h"
+#include "damage.hpp"
+#include "profiler.hpp"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -43,10 +45,20 @@ public:
 
     // print function without helper functions
     void print(const char* format, ...);
+
+    // Framebuffer the text is drawn into
+    void setFrameBuffer(uint16_t* frameBuffer);
+    uint16_t* getFrameBuffer(void) { return this->frameBuffer; }
+    void setBand(uint16_t* buffer, int32_t top, uint32_t rows);
+    void setDamageTracker(damageTracker* tracker) { this->damage = tracker; }
 private:
     // Display variables
     uint16_t* frameBuffer;
     display_config_t* config;
+    damageTracker* damage = nullptr;
+    // pixel indices that can be drawn to, the whole display unless a band is set
+    uint32_t bandStart = 0;
+    uint32_t bandEnd = UINT32_MAX;
 
     // print variables
     char characterBuffer[CHARACTER_BUFFER_SIZE];
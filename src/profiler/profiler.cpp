@@ -0,0 +1,249 @@
+#include "profiler.hpp"
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "graphics.hpp"
+#include "print.hpp"
+
+// Width of the overlay and the most calls it lists
+#define PROFILE_OVERLAY_WIDTH 120
+#define PROFILE_OVERLAY_LINES 6
+
+profile_frame_t profiler::frames[PROFILE_FRAMES];
+profile_frame_t profiler::current;
+uint32_t profiler::frameCount = 0;
+uint32_t profiler::frameStart = 0;
+uint32_t profiler::depth[2] = { 0, 0 };
+uint32_t profiler::busDepth[2] = { 0, 0 };
+uint32_t profiler::busBytes[2] = { 0, 0 };
+uint32_t profiler::busTime[2] = { 0, 0 };
+uint32_t profiler::lastBusBytes = 0;
+uint32_t profiler::lastBusTime = 0;
+
+/**
+ * @brief Close the frame that is being recorded and start the next one
+ * @note Called by display::frameCounter(), call it directly when that is not used
+*/
+void profiler::endFrame(void)
+{
+    uint32_t now = time_us_32();
+    uint32_t totalBytes = busBytes[0] + busBytes[1];
+    uint32_t totalTime = busTime[0] + busTime[1];
+
+    current.frame = frameCount;
+    current.time = now - frameStart;
+    current.busBytes = totalBytes - lastBusBytes;
+    current.busTime = totalTime - lastBusTime;
+    frames[frameCount % PROFILE_FRAMES] = current;
+    frameCount++;
+
+    memset(&current, 0, sizeof(current));
+    frameStart = now;
+    lastBusBytes = totalBytes;
+    lastBusTime = totalTime;
+}
+
+/**
+ * @brief Throw away every recorded frame
+*/
+void profiler::reset(void)
+{
+    memset(&current, 0, sizeof(current));
+    frameCount = 0;
+    frameStart = time_us_32();
+    lastBusBytes = busBytes[0] + busBytes[1];
+    lastBusTime = busTime[0] + busTime[1];
+}
+
+/**
+ * @brief Get a finished frame
+ * @param age 0 for the last finished frame, 1 for the one before and so on
+ * @return const profile_frame_t* The frame, nullptr if it is no longer or not yet kept
+*/
+const profile_frame_t* profiler::getFrame(uint32_t age)
+{
+    uint32_t kept = frameCount < PROFILE_FRAMES ? frameCount : PROFILE_FRAMES;
+    if (age >= kept)
+        return nullptr;
+
+    return &frames[(frameCount - 1 - age) % PROFILE_FRAMES];
+}
+
+/**
+ * @brief Print every kept frame over stdio, oldest first
+*/
+void profiler::dump(void)
+{
+    uint32_t kept = frameCount < PROFILE_FRAMES ? frameCount : PROFILE_FRAMES;
+    for (uint32_t age = kept; age-- > 0;)
+    {
+        const profile_frame_t* frame = getFrame(age);
+        printf("frame %u: %u us, bus %u bytes in %u us\n", frame->frame, frame->time, frame->busBytes, frame->busTime);
+
+        for (size_t i = 0; i < frame->count; i++)
+        {
+            const profile_entry_t* entry = &frame->entries[i];
+            printf("  %-26s %5u calls %7u us %8u px\n", entry->name, entry->calls, entry->time, entry->pixels);
+        }
+
+        if (frame->dropped)
+            printf("  %u calls dropped\n", frame->dropped);
+    }
+}
+
+/**
+ * @brief Draw the last finished frame on the screen
+ * @param gfx Graphics to draw the bars with
+ * @param text Printer to draw the text with, it needs a font
+ * @param position Upper left corner of the overlay
+ * @param lineHeight Height of a line of text
+ * @note The overlay itself is not recorded, it has to fit on the screen
+*/
+void profiler::drawOverlay(graphics* gfx, printer* text, point position, uint32_t lineHeight)
+{
+    const profile_frame_t* frame = getFrame(0);
+    if (frame == nullptr)
+        return;
+
+    // count the overlay as part of whatever call is running so it is not recorded
+    depth[get_core_num()]++;
+
+    // list the slowest calls first
+    size_t order[PROFILE_MAX_ENTRIES];
+    size_t lines = frame->count < PROFILE_OVERLAY_LINES ? frame->count : PROFILE_OVERLAY_LINES;
+    for (size_t i = 0; i < frame->count; i++)
+        order[i] = i;
+    for (size_t i = 0; i < lines; i++)
+    {
+        for (size_t j = i + 1; j < frame->count; j++)
+        {
+            if (frame->entries[order[j]].time > frame->entries[order[i]].time)
+            {
+                size_t swap = order[i];
+                order[i] = order[j];
+                order[j] = swap;
+            }
+        }
+    }
+
+    gfx->drawFilledRectangle(position, position + point(PROFILE_OVERLAY_WIDTH, (lines + 1) * lineHeight), colors::black);
+
+    // the frame against the budget, then every call against the budget
+    uint32_t bar = imin(frame->time * PROFILE_OVERLAY_WIDTH / PROFILE_BUDGET_US, PROFILE_OVERLAY_WIDTH);
+    if (bar > 0)
+        gfx->drawFilledRectangle(position, position + point(bar, lineHeight), frame->time > PROFILE_BUDGET_US ? colors::red : colors::green);
+    for (size_t i = 0; i < lines; i++)
+    {
+        const profile_entry_t* entry = &frame->entries[order[i]];
+        point start = position + point(0, (i + 1) * lineHeight);
+        bar = imin(entry->time * PROFILE_OVERLAY_WIDTH / PROFILE_BUDGET_US, PROFILE_OVERLAY_WIDTH);
+        if (bar > 0)
+            gfx->drawFilledRectangle(start, start + point(bar, lineHeight), colors::blue);
+    }
+
+    color previous = text->getColor();
+    text->setColor(colors::white);
+    text->setCursor(position);
+    text->print("%u us %u kB", frame->time, frame->busBytes >> 10);
+    for (size_t i = 0; i < lines; i++)
+    {
+        const profile_entry_t* entry = &frame->entries[order[i]];
+        text->setCursor(position + point(0, (i + 1) * lineHeight));
+        text->print("%s %u", entry->name, entry->time);
+    }
+    text->setColor(previous);
+
+    depth[get_core_num()]--;
+}
+
+/**
+ * @brief Start timing a drawing call
+ * @return bool True if no other call is being timed on this core
+*/
+bool profiler::enter(void)
+{
+    return depth[get_core_num()]++ == 0;
+}
+
+/**
+ * @brief Stop timing a drawing call
+ * @param name Name of the call, calls are added up by name
+ * @param time Microseconds spent in the call, ignored when name is nullptr
+ * @param pixels Pixels the call covered
+ * @note Only calls made on core 0 are recorded
+*/
+void profiler::leave(const char* name, uint32_t time, uint32_t pixels)
+{
+    uint core = get_core_num();
+    depth[core]--;
+    if (name == nullptr || core != 0)
+        return;
+
+    size_t i = 0;
+    while (i < current.count && current.entries[i].name != name && strcmp(current.entries[i].name, name) != 0)
+        i++;
+
+    if (i == current.count)
+    {
+        if (current.count == PROFILE_MAX_ENTRIES)
+        {
+            current.dropped++;
+            return;
+        }
+        current.entries[current.count++] = { name, 0, 0, 0 };
+    }
+
+    current.entries[i].calls++;
+    current.entries[i].time += time;
+    current.entries[i].pixels += pixels;
+}
+
+/**
+ * @brief Start timing a driver call
+ * @return bool True if no other driver call is being timed on this core
+*/
+bool profiler::enterBus(void)
+{
+    return busDepth[get_core_num()]++ == 0;
+}
+
+/**
+ * @brief Stop timing a driver call
+ * @param time Microseconds spent in the call, 0 for nested calls
+ * @param bytes Bytes the call handed to the display
+*/
+void profiler::leaveBus(uint32_t time, uint32_t bytes)
+{
+    uint core = get_core_num();
+    busDepth[core]--;
+    busTime[core] += time;
+    busBytes[core] += bytes;
+}
+
+profileScope::profileScope(const char* name, uint32_t pixels)
+{
+    this->name = name;
+    this->pixels = pixels;
+    this->outermost = profiler::enter();
+    this->start = this->outermost ? time_us_32() : 0;
+}
+
+profileScope::~profileScope()
+{
+    if (this->outermost)
+        profiler::leave(this->name, time_us_32() - this->start, this->pixels);
+    else
+        profiler::leave(nullptr, 0, 0);
+}
+
+profileBusScope::profileBusScope(uint32_t bytes)
+{
+    this->bytes = bytes;
+    this->outermost = profiler::enterBus();
+    this->start = this->outermost ? time_us_32() : 0;
+}
+
+profileBusScope::~profileBusScope()
+{
+    profiler::leaveBus(this->outermost ? time_us_32() - this->start : 0, this->bytes);
+}
\ No newline at end of file
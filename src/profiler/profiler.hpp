@@ -0,0 +1,161 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "pico/platform.h"
+#include "shapes.hpp"
+
+// Profiling is compiled in when PICOGFX_PROFILE is defined, without it the
+// PROFILE_* macros are empty and the drawing calls carry no overhead
+
+// Number of finished frames that are kept
+#ifndef PROFILE_FRAMES
+#define PROFILE_FRAMES 8
+#endif
+
+// Number of different calls that are told apart in a frame, the rest is counted as dropped
+#ifndef PROFILE_MAX_ENTRIES
+#define PROFILE_MAX_ENTRIES 24
+#endif
+
+// Frame budget the overlay bars are drawn against, in microseconds
+#ifndef PROFILE_BUDGET_US
+#define PROFILE_BUDGET_US 16667
+#endif
+
+class graphics;
+class printer;
+
+typedef struct
+{
+    const char* name;
+    uint32_t calls;
+    uint32_t time;      // microseconds spent in the call
+    uint32_t pixels;    // pixels the call covered, estimated from its arguments
+} profile_entry_t;
+
+typedef struct
+{
+    uint32_t frame;
+    uint32_t time;      // microseconds since the end of the previous frame
+    uint32_t busBytes;  // bytes handed to the display
+    uint32_t busTime;   // microseconds spent in the driver sending and waiting on the bus
+    uint32_t dropped;   // calls that did not fit in the entries
+    size_t count;
+    profile_entry_t entries[PROFILE_MAX_ENTRIES];
+} profile_frame_t;
+
+class profiler
+{
+public:
+    static void endFrame(void);
+    static void reset(void);
+
+    static uint32_t getFrameCount(void) { return frameCount; }
+    static const profile_frame_t* getFrame(uint32_t age = 0);
+
+    static void dump(void);
+    static void drawOverlay(graphics* gfx, printer* text, point position, uint32_t lineHeight);
+
+    // Used by the PROFILE_* macros
+    static bool enter(void);
+    static void leave(const char* name, uint32_t time, uint32_t pixels);
+    static bool enterBus(void);
+    static void leaveBus(uint32_t time, uint32_t bytes);
+    static void addBusBytes(uint32_t bytes) { busBytes[get_core_num()] += bytes; }
+private:
+    static profile_frame_t frames[PROFILE_FRAMES];
+    static profile_frame_t current;
+    static uint32_t frameCount;
+    static uint32_t frameStart;
+
+    // nesting of the scopes on each core, only the outermost call is timed
+    static uint32_t depth[2];
+    static uint32_t busDepth[2];
+    // running bus totals of each core, a core only ever writes its own
+    static uint32_t busBytes[2];
+    static uint32_t busTime[2];
+    static uint32_t lastBusBytes;
+    static uint32_t lastBusTime;
+};
+
+// Times a drawing call until the end of the enclosing scope
+class profileScope
+{
+public:
+    profileScope(const char* name, uint32_t pixels);
+    ~profileScope();
+private:
+    const char* name;
+    uint32_t pixels;
+    uint32_t start;
+    bool outermost;
+};
+
+// Times a driver call until the end of the enclosing scope
+class profileBusScope
+{
+public:
+    profileBusScope(uint32_t bytes);
+    ~profileBusScope();
+private:
+    uint32_t bytes;
+    uint32_t start;
+    bool outermost;
+};
+
+// Estimates of the pixels a call covers, only evaluated when profiling
+inline uint32_t profileLength(point a, point b)
+{
+    return imax(iabs(b.x - a.x), iabs(b.y - a.y)) + 1;
+}
+
+inline uint32_t profileCircleArea(int32_t radius)
+{
+    return (355 * radius * radius) / 113;
+}
+
+inline uint32_t profileTriangleArea(point a, point b, point c)
+{
+    return iabs((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y)) / 2;
+}
+
+inline uint32_t profilePolygonLength(const point* points, size_t numberOfPoints)
+{
+    uint32_t length = 0;
+    for (size_t i = 0; i < numberOfPoints; i++)
+        length += profileLength(points[i], points[(i + 1) % numberOfPoints]);
+    return length;
+}
+
+inline uint32_t profilePolylineLength(const point* points, size_t numberOfPoints)
+{
+    uint32_t length = 0;
+    for (size_t i = 0; i + 1 < numberOfPoints; i++)
+        length += profileLength(points[i], points[i + 1]);
+    return length;
+}
+
+inline uint32_t profilePolygonArea(const point* points, size_t numberOfPoints)
+{
+    int32_t area = 0;
+    for (size_t i = 0; i < numberOfPoints; i++)
+    {
+        const point& a = points[i];
+        const point& b = points[(i + 1) % numberOfPoints];
+        area += a.x * b.y - b.x * a.y;
+    }
+    return iabs(area) / 2;
+}
+
+#ifdef PICOGFX_PROFILE
+#define PROFILE_SCOPE(name, pixels) profileScope profileScope_((name), (pixels))
+#define PROFILE_BUS(bytes) profileBusScope profileBusScope_((bytes))
+#define PROFILE_BUS_BYTES(bytes) profiler::addBusBytes((bytes))
+#define PROFILE_FRAME() profiler::endFrame()
+#else
+#define PROFILE_SCOPE(name, pixels)
+#define PROFILE_BUS(bytes)
+#define PROFILE_BUS_BYTES(bytes)
+#define PROFILE_FRAME()
+#endif
\ No newline at end of file
@@ -0,0 +1,680 @@
+#include "scene.hpp"
+
+/**
+ * @brief Construct a new scene
+ * @param gfx Graphics object the shapes are replayed with
+ * @param print Printer object the text is replayed with, can be nullptr
+ * @param grad Gradient object the gradients are replayed with, can be nullptr
+ * @note A scene records drawing commands once so they can be replayed for every band of the display
+*/
+scene::scene(graphics* gfx, printer* print, gradient* grad)
+{
+    this->gfx = gfx;
+    this->print = print;
+    this->grad = grad;
+}
+
+/**
+ * @brief Remove every recorded command
+*/
+void scene::clear(void)
+{
+    this->count = 0;
+}
+
+/**
+ * @brief Record a fill of the whole display
+ * @param color color to fill with
+*/
+void scene::fill(color color)
+{
+    scene_command_t* command = this->add(SceneFill, INT32_MIN, INT32_MAX);
+    if (command == nullptr)
+        return;
+
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a line
+ * @param start Start point
+ * @param end End point
+ * @param color color to draw in
+*/
+void scene::drawLine(point start, point end, color color)
+{
+    scene_command_t* command = this->add(SceneLine, imin(start.y, end.y), imax(start.y, end.y));
+    if (command == nullptr)
+        return;
+
+    command->points[0] = start;
+    command->points[1] = end;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record an anti-aliased line
+ * @param start Start point
+ * @param end End point
+ * @param color color to draw in
+*/
+void scene::drawLineAntiAliased(point start, point end, color color)
+{
+    // the blended pixels can sit one row past the end points
+    scene_command_t* command = this->add(SceneLineAntiAliased, imin(start.y, end.y) - 1, imax(start.y, end.y) + 1);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = start;
+    command->points[1] = end;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a thick anti-aliased line
+ * @param start Start point
+ * @param end End point
+ * @param thickness Thickness of the line
+ * @param color color to draw in
+ * @param cap How the ends of the line are drawn
+*/
+void scene::drawLineThickAntiAliased(point start, point end, uint32_t thickness, color color, line_cap_t cap)
+{
+    int32_t reach = ((int32_t)thickness * GRAPHICS_MITER_LIMIT + 1) / 2 + 2;
+    scene_command_t* command = this->add(SceneLineThickAntiAliased, imin(start.y, end.y) - reach, imax(start.y, end.y) + reach);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = start;
+    command->points[1] = end;
+    command->values[0] = thickness;
+    command->values[1] = cap;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record connected anti-aliased lines
+ * @param points Points to connect, not copied
+ * @param numberOfPoints Number of points
+ * @param thickness Thickness of the lines
+ * @param color color to draw in
+ * @param cap How the ends of the first and last line are drawn
+ * @param join How the lines are joined where they meet
+*/
+void scene::drawPolyline(point* points, size_t numberOfPoints, uint32_t thickness, color color, line_cap_t cap, line_join_t join)
+{
+    int32_t top = INT32_MAX;
+    int32_t bottom = INT32_MIN;
+    for (size_t i = 0; i < numberOfPoints; i++)
+    {
+        top = imin(top, points[i].y);
+        bottom = imax(bottom, points[i].y);
+    }
+
+    // a miter reaches furthest past the points
+    int32_t reach = ((int32_t)thickness * GRAPHICS_MITER_LIMIT + 1) / 2 + 2;
+    scene_command_t* command = this->add(ScenePolyline, top - reach, bottom + reach);
+    if (command == nullptr)
+        return;
+
+    command->data = points;
+    command->values[0] = numberOfPoints;
+    command->values[1] = thickness;
+    command->values[2] = cap;
+    command->values[3] = join;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a rectangle outline
+ * @param start Start point
+ * @param end End point
+ * @param color color to draw in
+*/
+void scene::drawRectangle(point start, point end, color color)
+{
+    scene_command_t* command = this->add(SceneRectangle, imin(start.y, end.y), imax(start.y, end.y));
+    if (command == nullptr)
+        return;
+
+    command->points[0] = start;
+    command->points[1] = end;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a filled rectangle
+ * @param start Start point
+ * @param end End point, not included in the rectangle
+ * @param color color to draw in
+*/
+void scene::drawFilledRectangle(point start, point end, color color)
+{
+    scene_command_t* command = this->add(SceneFilledRectangle, start.y, end.y - 1);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = start;
+    command->points[1] = end;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a filled rectangle with rounded corners
+ * @param start Start point
+ * @param end End point, not included in the rectangle
+ * @param radius Radius of the corners
+ * @param color color to draw in
+*/
+void scene::drawFilledRoundedRectangle(point start, point end, uint32_t radius, color color)
+{
+    scene_command_t* command = this->add(SceneFilledRoundedRectangle, start.y, end.y - 1);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = start;
+    command->points[1] = end;
+    command->values[0] = radius;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a triangle outline
+ * @param p1 First point
+ * @param p2 Second point
+ * @param p3 Third point
+ * @param color color to draw in
+*/
+void scene::drawTriangle(point p1, point p2, point p3, color color)
+{
+    scene_command_t* command = this->add(SceneTriangle, 
+        imin(imin(p1.y, p2.y), p3.y), imax(imax(p1.y, p2.y), p3.y));
+    if (command == nullptr)
+        return;
+
+    command->points[0] = p1;
+    command->points[1] = p2;
+    command->points[2] = p3;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a filled triangle
+ * @param p1 First point
+ * @param p2 Second point
+ * @param p3 Third point
+ * @param color color to draw in
+*/
+void scene::drawFilledTriangle(point p1, point p2, point p3, color color)
+{
+    scene_command_t* command = this->add(SceneFilledTriangle, 
+        imin(imin(p1.y, p2.y), p3.y), imax(imax(p1.y, p2.y), p3.y));
+    if (command == nullptr)
+        return;
+
+    command->points[0] = p1;
+    command->points[1] = p2;
+    command->points[2] = p3;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a circle outline
+ * @param center Center point
+ * @param radius Radius of the circle
+ * @param color color to draw in
+ * @param thickness Thickness of the circle
+*/
+void scene::drawCircle(point center, uint32_t radius, color color, uint32_t thickness)
+{
+    int32_t reach = (int32_t)(radius + thickness);
+    scene_command_t* command = this->add(SceneCircle, center.y - reach, center.y + reach);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = center;
+    command->values[0] = radius;
+    command->values[1] = thickness;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a filled circle
+ * @param center Center point
+ * @param radius Radius of the circle
+ * @param color color to draw in
+*/
+void scene::drawFilledCircle(point center, uint32_t radius, color color)
+{
+    scene_command_t* command = this->add(SceneFilledCircle, center.y - (int32_t)radius, center.y + (int32_t)radius);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = center;
+    command->values[0] = radius;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a filled ellipse
+ * @param center Center point
+ * @param radiusX Horizontal radius of the ellipse
+ * @param radiusY Vertical radius of the ellipse
+ * @param color color to draw in
+*/
+void scene::drawFilledEllipse(point center, uint32_t radiusX, uint32_t radiusY, color color)
+{
+    scene_command_t* command = this->add(SceneFilledEllipse, center.y - (int32_t)radiusY, center.y + (int32_t)radiusY);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = center;
+    command->values[0] = radiusX;
+    command->values[1] = radiusY;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record an anti-aliased circle outline
+ * @param center Center point
+ * @param radius Radius of the circle
+ * @param color color to draw in
+ * @param thickness Thickness of the circle, centered on the radius
+*/
+void scene::drawCircleAntiAliased(point center, uint32_t radius, color color, uint32_t thickness)
+{
+    int32_t reach = (int32_t)radius + (int32_t)imax(thickness, 1) / 2 + 1;
+    scene_command_t* command = this->add(SceneCircleAntiAliased, center.y - reach, center.y + reach);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = center;
+    command->values[0] = radius;
+    command->values[1] = thickness;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record an anti-aliased filled circle
+ * @param center Center point
+ * @param radius Radius of the circle
+ * @param color color to draw in
+*/
+void scene::drawFilledCircleAntiAliased(point center, uint32_t radius, color color)
+{
+    int32_t reach = (int32_t)radius + 1;
+    scene_command_t* command = this->add(SceneFilledCircleAntiAliased, center.y - reach, center.y + reach);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = center;
+    command->values[0] = radius;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record an arc
+ * @param center Center point
+ * @param radius Radius of the arc
+ * @param startAngle Start angle of the arc
+ * @param endAngle End angle of the arc
+ * @param color color to draw in
+*/
+void scene::drawArc(point center, uint32_t radius, uint32_t startAngle, uint32_t endAngle, color color)
+{
+    int32_t reach = (int32_t)radius + 1;
+    scene_command_t* command = this->add(SceneArc, center.y - reach, center.y + reach);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = center;
+    command->values[0] = radius;
+    command->values[1] = startAngle;
+    command->values[2] = endAngle;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record the part of a ring between two angles
+ * @param center Center point
+ * @param innerRadius Radius for the inner most arc
+ * @param outerRadius Radius for the outer most arc
+ * @param startAngle Angle in degrees for both arcs
+ * @param endAngle Angle in degrees for both arcs
+ * @param color color to draw in
+*/
+void scene::drawFilledDualArc(point center, uint32_t innerRadius, uint32_t outerRadius, uint32_t startAngle, uint32_t endAngle, color color)
+{
+    int32_t reach = (int32_t)outerRadius + 1;
+    scene_command_t* command = this->add(SceneFilledDualArc, center.y - reach, center.y + reach);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = center;
+    command->values[0] = innerRadius;
+    command->values[1] = outerRadius;
+    command->values[2] = startAngle;
+    command->values[3] = endAngle;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record an anti-aliased arc
+ * @param center Center point
+ * @param radius Radius of the arc
+ * @param startAngle Angle in degrees the arc starts at
+ * @param endAngle Angle in degrees the arc runs clockwise to
+ * @param color color to draw in
+ * @param thickness Thickness of the arc, centered on the radius
+*/
+void scene::drawArcAntiAliased(point center, uint32_t radius, uint32_t startAngle, uint32_t endAngle, color color, uint32_t thickness)
+{
+    int32_t reach = (int32_t)radius + (int32_t)imax(thickness, 1) / 2 + 1;
+    scene_command_t* command = this->add(SceneArcAntiAliased, center.y - reach, center.y + reach);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = center;
+    command->values[0] = radius;
+    command->values[1] = startAngle;
+    command->values[2] = endAngle;
+    command->values[3] = thickness;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record the part of a ring between two angles with anti-aliasing
+ * @param center Center point
+ * @param innerRadius Radius for the inner most arc
+ * @param outerRadius Radius for the outer most arc
+ * @param startAngle Angle in degrees for both arcs
+ * @param endAngle Angle in degrees for both arcs
+ * @param color color to draw in
+*/
+void scene::drawFilledDualArcAntiAliased(point center, uint32_t innerRadius, uint32_t outerRadius, uint32_t startAngle, uint32_t endAngle, color color)
+{
+    int32_t reach = (int32_t)outerRadius + 1;
+    scene_command_t* command = this->add(SceneFilledDualArcAntiAliased, center.y - reach, center.y + reach);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = center;
+    command->values[0] = innerRadius;
+    command->values[1] = outerRadius;
+    command->values[2] = startAngle;
+    command->values[3] = endAngle;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a polygon outline
+ * @param points Points of the polygon, not copied
+ * @param numberOfPoints Number of points
+ * @param color color to draw in
+*/
+void scene::drawPolygon(point* points, size_t numberOfPoints, color color)
+{
+    int32_t top = INT32_MAX;
+    int32_t bottom = INT32_MIN;
+    for (size_t i = 0; i < numberOfPoints; i++)
+    {
+        top = imin(top, points[i].y);
+        bottom = imax(bottom, points[i].y);
+    }
+
+    scene_command_t* command = this->add(ScenePolygon, top, bottom);
+    if (command == nullptr)
+        return;
+
+    command->data = points;
+    command->values[0] = numberOfPoints;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a filled polygon
+ * @param points Points of the polygon, not copied
+ * @param numberOfPoints Number of points
+ * @param color color to draw in
+ * @param rule How overlapping parts of the outline decide what is inside
+*/
+void scene::drawFilledPolygon(point* points, size_t numberOfPoints, color color, fill_rule_t rule)
+{
+    int32_t top = INT32_MAX;
+    int32_t bottom = INT32_MIN;
+    for (size_t i = 0; i < numberOfPoints; i++)
+    {
+        top = imin(top, points[i].y);
+        bottom = imax(bottom, points[i].y);
+    }
+
+    scene_command_t* command = this->add(SceneFilledPolygon, top, bottom);
+    if (command == nullptr)
+        return;
+
+    command->data = points;
+    command->values[0] = numberOfPoints;
+    command->values[1] = rule;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a bitmap
+ * @param bitmap Bitmap to draw, not copied
+ * @param width Width of the bitmap
+ * @param height Height of the bitmap
+ * @param start Upper left corner of the bitmap
+*/
+void scene::drawBitmap(const uint16_t* bitmap, uint32_t width, uint32_t height, point start)
+{
+    scene_command_t* command = this->add(SceneBitmap, start.y, start.y + (int32_t)height - 1);
+    if (command == nullptr)
+        return;
+
+    command->data = bitmap;
+    command->points[0] = start;
+    command->values[0] = width;
+    command->values[1] = height;
+}
+
+/**
+ * @brief Record a string
+ * @param position Where the printer cursor is placed
+ * @param text String to print, not copied
+ * @param color color to print in
+ * @note Text is replayed for every band as its height depends on the font
+*/
+void scene::drawText(point position, const char* text, color color)
+{
+    if (this->print == nullptr)
+        return;
+
+    scene_command_t* command = this->add(SceneText, INT32_MIN, INT32_MAX);
+    if (command == nullptr)
+        return;
+
+    command->data = text;
+    command->points[0] = position;
+    command->colors[0] = color;
+}
+
+/**
+ * @brief Record a gradient over the whole display
+ * @param startColor color to start with
+ * @param endColor color to end with
+ * @param start Start point
+ * @param end End point
+*/
+void scene::fillGradient(color startColor, color endColor, point start, point end)
+{
+    if (this->grad == nullptr)
+        return;
+
+    scene_command_t* command = this->add(SceneGradient, INT32_MIN, INT32_MAX);
+    if (command == nullptr)
+        return;
+
+    command->points[0] = start;
+    command->points[1] = end;
+    command->colors[0] = startColor;
+    command->colors[1] = endColor;
+}
+
+/**
+ * @brief Replay every command into the buffers the objects point at
+*/
+void scene::render(void)
+{
+    for (size_t i = 0; i < this->count; i++)
+        this->execute(&this->commands[i]);
+}
+
+/**
+ * @brief Replay the commands that touch a band of rows
+ * @param buffer Buffer of width * rows pixels
+ * @param top First display row held by the buffer
+ * @param rows Number of rows in the buffer
+ * @note The objects keep pointing at the band afterwards, see setFrameBuffer()
+*/
+void scene::renderBand(uint16_t* buffer, int32_t top, uint32_t rows)
+{
+    this->gfx->setBand(buffer, top, rows);
+    if (this->print != nullptr)
+        this->print->setBand(buffer, top, rows);
+    if (this->grad != nullptr)
+        this->grad->setBand(buffer, top, rows);
+
+    int32_t bottom = top + (int32_t)rows - 1;
+    for (size_t i = 0; i < this->count; i++)
+    {
+        // skip everything that cannot reach the band
+        scene_command_t* command = &this->commands[i];
+        if (command->bottom < top || command->top > bottom)
+            continue;
+
+        this->execute(command);
+    }
+}
+
+/**
+ * @brief Point the objects of the scene back at a whole frame buffer
+ * @param frameBuffer Buffer of width * height pixels
+*/
+void scene::setFrameBuffer(uint16_t* frameBuffer)
+{
+    this->gfx->setFrameBuffer(frameBuffer);
+    if (this->print != nullptr)
+        this->print->setFrameBuffer(frameBuffer);
+    if (this->grad != nullptr)
+        this->grad->setFrameBuffer(frameBuffer);
+}
+
+/**
+ * @private
+ * @brief Reserve the next command slot
+ * @param type Type of the command
+ * @param top First row the command can touch
+ * @param bottom Last row the command can touch
+ * @return scene_command_t* The command to fill in, nullptr if the scene is full
+*/
+scene_command_t* scene::add(scene_command_type_t type, int32_t top, int32_t bottom)
+{
+    if (this->count >= SCENE_MAX_COMMANDS)
+        return nullptr;
+
+    scene_command_t* command = &this->commands[this->count++];
+    command->type = type;
+    command->top = top;
+    command->bottom = bottom;
+    command->data = nullptr;
+    return command;
+}
+
+/**
+ * @private
+ * @brief Draw a single command
+ * @param command Command to draw
+*/
+void scene::execute(scene_command_t* command)
+{
+    point* p = command->points;
+    uint32_t* v = command->values;
+
+    switch (command->type)
+    {
+    case SceneFill:
+        this->gfx->fill(command->colors[0]);
+        break;
+    case SceneLine:
+        this->gfx->drawLine(p[0], p[1], command->colors[0]);
+        break;
+    case SceneLineAntiAliased:
+        this->gfx->drawLineAntiAliased(p[0], p[1], command->colors[0]);
+        break;
+    case SceneLineThickAntiAliased:
+        this->gfx->drawLineThickAntiAliased(p[0], p[1], v[0], command->colors[0], (line_cap_t)v[1]);
+        break;
+    case ScenePolyline:
+        this->gfx->drawPolyline((point*)command->data, v[0], v[1], command->colors[0], (line_cap_t)v[2], (line_join_t)v[3]);
+        break;
+    case SceneRectangle:
+        this->gfx->drawRectangle(p[0], p[1], command->colors[0]);
+        break;
+    case SceneFilledRectangle:
+        this->gfx->drawFilledRectangle(p[0], p[1], command->colors[0]);
+        break;
+    case SceneFilledRoundedRectangle:
+        this->gfx->drawFilledRoundedRectangle(p[0], p[1], v[0], command->colors[0]);
+        break;
+    case SceneTriangle:
+        this->gfx->drawTriangle(p[0], p[1], p[2], command->colors[0]);
+        break;
+    case SceneFilledTriangle:
+        this->gfx->drawFilledTriangle(p[0], p[1], p[2], command->colors[0]);
+        break;
+    case SceneCircle:
+        this->gfx->drawCircle(p[0], command->values[0], command->colors[0], command->values[1]);
+        break;
+    case SceneFilledCircle:
+        this->gfx->drawFilledCircle(p[0], command->values[0], command->colors[0]);
+        break;
+    case SceneFilledEllipse:
+        this->gfx->drawFilledEllipse(p[0], v[0], v[1], command->colors[0]);
+        break;
+    case SceneCircleAntiAliased:
+        this->gfx->drawCircleAntiAliased(p[0], v[0], command->colors[0], v[1]);
+        break;
+    case SceneFilledCircleAntiAliased:
+        this->gfx->drawFilledCircleAntiAliased(p[0], v[0], command->colors[0]);
+        break;
+    case SceneArc:
+        this->gfx->drawArc(p[0], v[0], v[1], v[2], command->colors[0]);
+        break;
+    case SceneFilledDualArc:
+        this->gfx->drawFilledDualArc(p[0], v[0], v[1], v[2], v[3], command->colors[0]);
+        break;
+    case SceneArcAntiAliased:
+        this->gfx->drawArcAntiAliased(p[0], v[0], v[1], v[2], command->colors[0], v[3]);
+        break;
+    case SceneFilledDualArcAntiAliased:
+        this->gfx->drawFilledDualArcAntiAliased(p[0], v[0], v[1], v[2], v[3], command->colors[0]);
+        break;
+    case ScenePolygon:
+        this->gfx->drawPolygon((point*)command->data, command->values[0], command->colors[0]);
+        break;
+    case SceneFilledPolygon:
+        this->gfx->drawFilledPolygon((point*)command->data, command->values[0], command->colors[0], (fill_rule_t)command->values[1]);
+        break;
+    case SceneBitmap:
+        this->gfx->drawBitmap((const uint16_t*)command->data, command->values[0], command->values[1], p[0]);
+        break;
+    case SceneText:
+        this->print->setColor(command->colors[0]);
+        this->print->setCursor(p[0]);
+        this->print->print("%s", (const char*)command->data);
+        break;
+    case SceneGradient:
+        this->grad->fillGradient(command->colors[0], command->colors[1], p[0], p[1]);
+        break;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "color.h"
+#include "shapes.hpp"
+#include "gfxmath.h"
+#include "graphics.hpp"
+#include "print.hpp"
+#include "gradient.hpp"
+
+// Number of drawing commands a scene can hold
+#ifndef SCENE_MAX_COMMANDS
+#define SCENE_MAX_COMMANDS 64
+#endif
+
+typedef enum
+{
+    SceneFill,
+    SceneLine,
+    SceneLineAntiAliased,
+    SceneLineThickAntiAliased,
+    ScenePolyline,
+    SceneRectangle,
+    SceneFilledRectangle,
+    SceneFilledRoundedRectangle,
+    SceneTriangle,
+    SceneFilledTriangle,
+    SceneCircle,
+    SceneFilledCircle,
+    SceneFilledEllipse,
+    SceneCircleAntiAliased,
+    SceneFilledCircleAntiAliased,
+    SceneArc,
+    SceneFilledDualArc,
+    SceneArcAntiAliased,
+    SceneFilledDualArcAntiAliased,
+    ScenePolygon,
+    SceneFilledPolygon,
+    SceneBitmap,
+    SceneText,
+    SceneGradient,
+} scene_command_type_t;
+
+typedef struct
+{
+    scene_command_type_t type;
+    int32_t top;            // first row the command can touch
+    int32_t bottom;         // last row the command can touch
+    point points[3];
+    uint32_t values[4];     // radii, angles, thickness, counts and styles, in the order graphics takes them
+    color colors[2];
+    const void* data;       // caller owned, has to live as long as the scene
+} scene_command_t;
+
+class scene
+{
+public:
+    scene(graphics* gfx, printer* print = nullptr, gradient* grad = nullptr);
+
+    void clear(void);
+    size_t getCount(void) { return this->count; }
+    bool isFull(void) { return this->count >= SCENE_MAX_COMMANDS; }
+
+    void fill(color color);
+    void drawLine(point start, point end, color color = colors::white);
+    void drawLineAntiAliased(point start, point end, color color = colors::white);
+    void drawLineThickAntiAliased(point start, point end, uint32_t thickness, color color = colors::white, line_cap_t cap = CapButt);
+    void drawPolyline(point* points, size_t numberOfPoints, uint32_t thickness, color color = colors::white, line_cap_t cap = CapButt, line_join_t join = JoinMiter);
+    void drawRectangle(point start, point end, color color = colors::white);
+    void drawFilledRectangle(point start, point end, color color = colors::white);
+    void drawFilledRoundedRectangle(point start, point end, uint32_t radius, color color = colors::white);
+    void drawTriangle(point p1, point p2, point p3, color color = colors::white);
+    void drawFilledTriangle(point p1, point p2, point p3, color color = colors::white);
+    void drawCircle(point center, uint32_t radius, color color = colors::white, uint32_t thickness = 1);
+    void drawFilledCircle(point center, uint32_t radius, color color = colors::white);
+    void drawFilledEllipse(point center, uint32_t radiusX, uint32_t radiusY, color color = colors::white);
+    void drawCircleAntiAliased(point center, uint32_t radius, color color = colors::white, uint32_t thickness = 1);
+    void drawFilledCircleAntiAliased(point center, uint32_t radius, color color = colors::white);
+    void drawArc(point center, uint32_t radius, uint32_t startAngle, uint32_t endAngle, color color = colors::white);
+    void drawFilledDualArc(point center, uint32_t innerRadius, uint32_t outerRadius, uint32_t startAngle, uint32_t endAngle, color color);
+    void drawArcAntiAliased(point center, uint32_t radius, uint32_t startAngle, uint32_t endAngle, color color = colors::white, uint32_t thickness = 1);
+    void drawFilledDualArcAntiAliased(point center, uint32_t innerRadius, uint32_t outerRadius, uint32_t startAngle, uint32_t endAngle, color color);
+    void drawPolygon(point* points, size_t numberOfPoints, color color = colors::white);
+    void drawFilledPolygon(point* points, size_t numberOfPoints, color color = colors::white, fill_rule_t rule = FillNonZero);
+    void drawBitmap(const uint16_t* bitmap, uint32_t width, uint32_t height, point start);
+    void drawText(point position, const char* text, color color = colors::white);
+    void fillGradient(color startColor, color endColor, point start, point end);
+
+    void render(void);
+    void renderBand(uint16_t* buffer, int32_t top, uint32_t rows);
+    void setFrameBuffer(uint16_t* frameBuffer);
+
+private:
+    graphics* gfx;
+    printer* print;
+    gradient* grad;
+    scene_command_t commands[SCENE_MAX_COMMANDS];
+    size_t count = 0;
+
+    scene_command_t* add(scene_command_type_t type, int32_t top, int32_t bottom);
+    void execute(scene_command_t* command);
+};
\ No newline at end of file
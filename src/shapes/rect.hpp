@@ -241,11 +241,11 @@ public:
      */
     rect clamp(point min, point max)
     {
-        // Clamp the sides of the rect
-        uint32_t x1 = imax(this->px.x, min.x);
-        uint32_t y1 = imax(this->px.y, min.y);
-        uint32_t x2 = imin(this->py.x, max.x);
-        uint32_t y2 = imin(this->py.y, max.y);
+        // Clamp the sides of the rect, px holds the bottom and py the top
+        int32_t x1 = imax(this->px.x, min.x);
+        int32_t y1 = imax(this->py.y, min.y);
+        int32_t x2 = imin(this->py.x, max.x);
+        int32_t y2 = imin(this->px.y, max.y);
 
         // Return the new rect
         return rect(point(x1, y1), point(x2, y2));